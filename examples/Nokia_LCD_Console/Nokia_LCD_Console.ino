@@ -0,0 +1,27 @@
+#include <Nokia_LCD.h>
+#include <Nokia_LCD_Console.h>
+
+Nokia_LCD lcd(13 /* CLK */, 12 /* DIN */, 11 /* DC */, 10 /* CE */, 9 /* RST */);
+// The console remembers what is on the screen so it can scroll it
+Nokia_LCD_Console console(lcd);
+
+unsigned int counter = 0;
+
+void setup() {
+  // Initialize the screen
+  lcd.begin();
+  // Set the contrast
+  lcd.setContrast(60);  // Good values are usualy between 40 and 60
+  // Clear the console and the screen
+  console.clear();
+  console.println("Booting...");
+}
+
+void loop() {
+  // Once the last line is used, the console scrolls up by one line and only
+  // the lines that changed are sent to the display
+  console.print("Tick ");
+  console.println(counter % 2 == 0 ? "even" : "odd");
+  counter++;
+  delay(1000);
+}
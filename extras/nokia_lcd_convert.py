@@ -0,0 +1,650 @@
+#!/usr/bin/env python3
+"""
+Converts images to C headers with bitmaps for the Nokia 5110 LCD library.
+
+Bitmaps are laid out the way `Nokia_LCD::draw()` expects them: every byte is a
+column of 8 pixels, the least significant bit at the top, and the bytes go
+from left to right, one 8 pixel tall row after the other.
+
+Usage:
+    nokia_lcd_convert.py image IMAGE [options]
+    nokia_lcd_convert.py font IMAGE --glyph WxH [options]
+
+The `image` command emits a bitmap for `draw()` or, with `--rle`, a compressed
+one for `drawStream()` and `RleIterator`. With `--sprite WxH` every cell of a
+sprite sheet becomes a separate bitmap. The `font` command turns a grid of
+glyphs into a font for `LcdFont`, the glyphs ordered from left to right and
+then top to bottom, starting with the `--first` character. With `--packed`
+only the rows the glyphs use are stored, bit by bit, and with `--chars` only
+the glyphs of the supplied characters, e.g. `--chars 0123456789.-`. Glyphs
+beyond ASCII are printed from UTF-8 text, e.g. `--first 0xb0` for a row of
+Latin-1 glyphs, and `--fallback ?` picks the glyph of missing characters.
+
+PBM, PGM and PNG images are supported. Dark pixels, darker than `--threshold`,
+are drawn, unless `--invert` is given. With `--dither`, gray images are
+dithered instead. The sizes of the results in flash memory are reported on the
+standard error. Only the Python standard library is needed.
+"""
+import argparse
+import os
+import re
+import struct
+import sys
+import zlib
+
+PAGE_HEIGHT = 8
+BYTES_PER_LINE = 12
+
+
+class Image:
+    """A grayscale image, 0 is black and 255 is white"""
+
+    def __init__(self, width, height, pixels):
+        self.width = width
+        self.height = height
+        self.pixels = pixels  # Rows of gray levels
+
+    @staticmethod
+    def load(path):
+        with open(path, "rb") as image_file:
+            content = image_file.read()
+        if content.startswith(b"\x89PNG\r\n\x1a\n"):
+            return load_png(content)
+        if content[:2] in (b"P1", b"P2", b"P4", b"P5"):
+            return load_netpbm(content)
+        raise ValueError("%s is not a PBM, PGM or PNG image" % path)
+
+
+def load_netpbm(content):
+    # The header is made of whitespace separated fields, with comments
+    fields = []
+    position = 0
+    expected = 2 if content[:2] in (b"P1", b"P4") else 3
+    while len(fields) < expected + 1:
+        match = re.compile(rb"\s*(#[^\n]*\n\s*)*(\S+)").match(content, position)
+        if not match:
+            raise ValueError("The image header is incomplete")
+        fields.append(match.group(2))
+        position = match.end()
+    kind = fields[0]
+    width, height = int(fields[1]), int(fields[2])
+    maximum = int(fields[3]) if expected == 3 else 1
+    if kind in (b"P4", b"P5"):
+        position += 1  # A single whitespace separates the header from pixels
+    raster = content[position:]
+
+    if kind == b"P4":
+        stride = (width + 7) // 8
+        pixels = [
+            [
+                0 if raster[y * stride + x // 8] >> (7 - x % 8) & 1 else 255
+                for x in range(width)
+            ]
+            for y in range(height)
+        ]
+        return Image(width, height, pixels)
+
+    if kind == b"P5":
+        sample_size = 2 if maximum > 255 else 1
+        samples = [
+            int.from_bytes(raster[i : i + sample_size], "big")
+            for i in range(0, width * height * sample_size, sample_size)
+        ]
+    elif kind == b"P1":
+        # Plain bitmaps may omit the whitespace between pixels, 1 is black
+        digits = re.sub(rb"\s", b"", raster)[: width * height]
+        samples = [1 - int(chr(digit)) for digit in digits]
+    else:
+        samples = [int(value) for value in raster.split()]
+
+    pixels = [
+        [samples[y * width + x] * 255 // maximum for x in range(width)]
+        for y in range(height)
+    ]
+    return Image(width, height, pixels)
+
+
+def load_png(content):
+    position = 8
+    palette = []
+    data = b""
+    while position < len(content):
+        length, kind = struct.unpack_from(">I4s", content, position)
+        chunk = content[position + 8 : position + 8 + length]
+        position += 12 + length
+        if kind == b"IHDR":
+            width, height, depth, color, _, _, interlace = struct.unpack(
+                ">IIBBBBB", chunk
+            )
+        elif kind == b"PLTE":
+            palette = [tuple(chunk[i : i + 3]) for i in range(0, length, 3)]
+        elif kind == b"IDAT":
+            data += chunk
+        elif kind == b"IEND":
+            break
+    if interlace:
+        raise ValueError("Interlaced PNG images are not supported")
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}[color]
+    bits_per_pixel = channels * depth
+    stride = (width * bits_per_pixel + 7) // 8
+    pixel_size = max(1, bits_per_pixel // 8)
+    raw = zlib.decompress(data)
+
+    rows = []
+    previous = bytearray(stride)
+    for y in range(height):
+        start = y * (stride + 1)
+        kind = raw[start]
+        line = bytearray(raw[start + 1 : start + 1 + stride])
+        for i in range(stride):
+            left = line[i - pixel_size] if i >= pixel_size else 0
+            up = previous[i]
+            up_left = previous[i - pixel_size] if i >= pixel_size else 0
+            if kind == 1:
+                line[i] = (line[i] + left) & 0xFF
+            elif kind == 2:
+                line[i] = (line[i] + up) & 0xFF
+            elif kind == 3:
+                line[i] = (line[i] + (left + up) // 2) & 0xFF
+            elif kind == 4:
+                estimate = left + up - up_left
+                distances = (
+                    abs(estimate - left),
+                    abs(estimate - up),
+                    abs(estimate - up_left),
+                )
+                if distances[0] <= distances[1] and distances[0] <= distances[2]:
+                    predictor = left
+                elif distances[1] <= distances[2]:
+                    predictor = up
+                else:
+                    predictor = up_left
+                line[i] = (line[i] + predictor) & 0xFF
+        rows.append(line)
+        previous = line
+
+    maximum = (1 << depth) - 1
+
+    def sample(line, index):
+        if depth == 16:
+            return (line[index * 2] << 8 | line[index * 2 + 1]) >> 8
+        if depth == 8:
+            return line[index]
+        bit = index * depth
+        value = line[bit // 8] >> (8 - depth - bit % 8) & maximum
+        return value if color == 3 else value * 255 // maximum
+
+    pixels = []
+    for line in rows:
+        row = []
+        for x in range(width):
+            values = [sample(line, x * channels + c) for c in range(channels)]
+            if color == 3:
+                values = list(palette[values[0]])
+            alpha = 255
+            if color in (4, 6):
+                alpha = values.pop()
+            if len(values) == 3:
+                gray = (299 * values[0] + 587 * values[1] + 114 * values[2]) // 1000
+            else:
+                gray = values[0]
+            # Transparent pixels are shown as the white background
+            row.append((gray * alpha + 255 * (255 - alpha)) // 255)
+        pixels.append(row)
+
+    return Image(width, height, pixels)
+
+
+def to_bits(image, threshold, dither, invert):
+    """Returns rows of booleans, True for the pixels to be drawn"""
+    if not dither:
+        return [
+            [(gray < threshold) != invert for gray in row] for row in image.pixels
+        ]
+
+    # Floyd-Steinberg error diffusion
+    levels = [[float(gray) for gray in row] for row in image.pixels]
+    bits = []
+    for y in range(image.height):
+        row = []
+        for x in range(image.width):
+            old = levels[y][x]
+            black = old < threshold
+            error = old - (0 if black else 255)
+            row.append(black != invert)
+            for dx, dy, weight in ((1, 0, 7), (-1, 1, 3), (0, 1, 5), (1, 1, 1)):
+                if 0 <= x + dx < image.width and y + dy < image.height:
+                    levels[y + dy][x + dx] += error * weight / 16
+        bits.append(row)
+    return bits
+
+
+def bounding_box(bits):
+    """Returns left, top, width and height of the drawn pixels"""
+    rows = [y for y, row in enumerate(bits) if any(row)]
+    columns = [x for x in range(len(bits[0])) if any(row[x] for row in bits)]
+    if not rows:
+        return 0, 0, 1, 1
+    return (
+        columns[0],
+        rows[0],
+        columns[-1] - columns[0] + 1,
+        rows[-1] - rows[0] + 1,
+    )
+
+
+def to_pages(bits):
+    """Packs the pixels into page bytes, padding the last page with blanks"""
+    height = len(bits)
+    width = len(bits[0])
+    pages = []
+    for page in range((height + PAGE_HEIGHT - 1) // PAGE_HEIGHT):
+        for x in range(width):
+            column = 0
+            for bit in range(PAGE_HEIGHT):
+                y = page * PAGE_HEIGHT + bit
+                if y < height and bits[y][x]:
+                    column |= 1 << bit
+            pages.append(column)
+    return pages
+
+
+def rle(data):
+    """Compresses the bytes in the format `RleIterator` reads"""
+    compressed = bytearray()
+    literal = bytearray()
+
+    def flush_literal():
+        while literal:
+            part = literal[:128]
+            compressed.append(len(part) - 1)
+            compressed.extend(part)
+            del literal[:128]
+
+    i = 0
+    while i < len(data):
+        run = 1
+        while i + run < len(data) and data[i + run] == data[i] and run < 129:
+            run += 1
+        if run >= 2:
+            flush_literal()
+            compressed.append(run + 126)
+            compressed.append(data[i])
+        else:
+            literal.append(data[i])
+        i += run
+    flush_literal()
+
+    return bytes(compressed)
+
+
+def c_array(data, indent):
+    lines = []
+    for i in range(0, len(data), BYTES_PER_LINE):
+        values = ", ".join("0x%02x" % b for b in data[i : i + BYTES_PER_LINE])
+        lines.append("%s%s," % (indent, values))
+    return "\n".join(lines)
+
+
+def identifier(name):
+    return re.sub(r"\W", "_", name)
+
+
+def slice_sprites(bits, sprite):
+    if not sprite:
+        return [bits]
+    width, height = sprite
+    sprites = []
+    for top in range(0, len(bits) - height + 1, height):
+        for left in range(0, len(bits[0]) - width + 1, width):
+            sprites.append([row[left : left + width] for row in bits[top : top + height]])
+    return sprites
+
+
+def convert_image(arguments, image):
+    bits = to_bits(image, arguments.threshold, arguments.dither, arguments.invert)
+    name = arguments.name
+    output = [
+        "#pragma once",
+        "// Generated by extras/nokia_lcd_convert.py from %s"
+        % os.path.basename(arguments.image),
+        "#include <Nokia_LCD_Flash.h>",
+        "",
+    ]
+    total = 0
+    sprites = slice_sprites(bits, arguments.sprite)
+    for index, sprite in enumerate(sprites):
+        if arguments.crop:
+            left, top, width, height = bounding_box(sprite)
+            sprite = [row[left : left + width] for row in sprite[top : top + height]]
+        width = len(sprite[0])
+        pages = to_pages(sprite)
+        data = rle(pages) if arguments.rle else pages
+        array = name if len(sprites) == 1 else "%s_%d" % (name, index)
+        if arguments.rle:
+            output.append(
+                "// %dx%d, %d bytes compressed to %d, draw with:"
+                % (width, len(sprite), len(pages), len(data))
+            )
+            output.append(
+                "// `lcd.drawStream(RleIterator(%s), RleIterator(%s + sizeof(%s)), "
+                "%s_width);`" % (array, array, array, array)
+            )
+        else:
+            output.append("// %dx%d, draw with:" % (width, len(sprite)))
+            output.append(
+                "// `lcd.draw(%s, sizeof(%s), true, %s_width);`" % (array, array, array)
+            )
+        output.append("const uint8_t %s_width = %d;" % (array, width))
+        output.append("const unsigned char %s[] PROGMEM = {" % array)
+        output.append(c_array(data, "    "))
+        output.append("};")
+        output.append("")
+        total += len(data)
+
+    print(
+        "%d bitmap(s), %d bytes of flash" % (len(sprites), total), file=sys.stderr
+    )
+    return "\n".join(output)
+
+
+def font_preamble(arguments):
+    return [
+        "#pragma once",
+        "#include <LCD_Fonts.h>",
+        "",
+        "/**",
+        " * Generated by extras/nokia_lcd_convert.py from %s"
+        % os.path.basename(arguments.image),
+        " **/",
+        "",
+    ]
+
+
+def glyph_widths(glyphs, width):
+    """Proportional glyphs are as wide as their rightmost drawn column"""
+    return [
+        max([x + 1 for x in range(width) if glyph[x]] or [width])
+        for glyph in glyphs
+    ]
+
+
+def code_ranges(codes):
+    """Groups sorted code points into (first, last, glyph) runs"""
+    ranges = []
+    for index, code in enumerate(codes):
+        if ranges and ranges[-1][1] + 1 == code:
+            ranges[-1][1] = code
+        else:
+            ranges.append([code, code, index])
+    return ranges
+
+
+def convert_packed_font(arguments, glyphs, codes):
+    width = arguments.glyph[0]
+    namespace = "%s_LCD_Fonts" % arguments.name
+    font = "%sFont" % arguments.name
+    order = sorted(range(len(codes)), key=lambda index: codes[index])
+    codes = [codes[index] for index in order]
+    glyphs = [glyphs[index] for index in order]
+    widths = (
+        glyph_widths(glyphs, width)
+        if arguments.proportional
+        else [width] * len(glyphs)
+    )
+
+    # Only the rows that any glyph draws on are stored
+    used = 0
+    for glyph in glyphs:
+        for column in glyph[:width]:
+            used |= column
+    top = min([row for row in range(PAGE_HEIGHT) if used >> row & 1] or [0])
+    bottom = max([row for row in range(PAGE_HEIGHT) if used >> row & 1] or [0])
+    height = bottom - top + 1
+
+    bits = []
+    starts = []
+    for glyph, glyph_width in zip(glyphs, widths):
+        starts.append(len(bits) // height)
+        for column in glyph[:glyph_width]:
+            bits.extend((column >> (top + row)) & 1 for row in range(height))
+    starts.append(len(bits) // height)
+    bitmap = [
+        sum(bit << index for index, bit in enumerate(bits[i : i + 8]))
+        for i in range(0, len(bits), 8)
+    ] or [0]
+    ranges = code_ranges(codes)
+    fallback = 0
+    if arguments.fallback is not None:
+        if len(arguments.fallback) != 1:
+            raise ValueError("The fallback has to be a single character")
+        fallback = ord(arguments.fallback)
+        if fallback not in codes:
+            raise ValueError("No glyph for the fallback %s" % arguments.fallback)
+
+    def printable(code):
+        # A backslash would continue the comment on the next line
+        if 0x20 < code < 0x7F and code != ord("\\"):
+            return chr(code)
+        return "0x%02x" % code
+
+    output = font_preamble(arguments)
+    output.extend(
+        [
+            "namespace %s {" % namespace,
+            "    const unsigned char hSpace[] = {%s};"
+            % ",".join(["0x00"] * max(1, arguments.spacing)),
+            "    const unsigned char hSpaceSize = %d;" % arguments.spacing,
+            "",
+            "    /* Packed glyphs:",
+            "    %d bits of each column, starting with row %d, one column after"
+            % (height, top),
+            "    the other and the lowest bit first. */",
+            "    const unsigned char kBitmap[] PROGMEM = {",
+            c_array(bitmap, "        "),
+            "    };",
+            "",
+        ]
+    )
+    flash = len(bitmap)
+    if arguments.proportional:
+        output.append("    const uint16_t kColumns[] PROGMEM = {")
+        output.append(
+            "\n".join(
+                "        %s," % ", ".join(str(start) for start in starts[i : i + 12])
+                for i in range(0, len(starts), 12)
+            )
+        )
+        output.extend(["    };", ""])
+        flash += 2 * len(starts)
+    output.append("    const GlyphRange kRanges[] PROGMEM = {")
+    for first, last, glyph in ranges:
+        characters = printable(first)
+        if last != first:
+            characters += " to " + printable(last)
+        output.append(
+            "        {0x%02x, 0x%02x, %d}, // %s" % (first, last, glyph, characters)
+        )
+    output.extend(
+        [
+            "    };",
+            "",
+            "    const PackedFont kPacked_font{kBitmap, %s, kRanges, %d, %d, %d, %d,"
+            % (
+                "kColumns" if arguments.proportional else "nullptr",
+                len(ranges),
+                width,
+                height,
+                top,
+            ),
+            "                                  0x%02x};" % fallback,
+            "    const LcdFont %s{&kPacked_font, hSpace, hSpaceSize};" % font,
+            "",
+            "}  // namespace %s" % namespace,
+            "",
+        ]
+    )
+    flash += 6 * len(ranges)
+
+    print(
+        "%d glyphs, %d rows each, %d bytes of flash"
+        % (len(glyphs), height, flash),
+        file=sys.stderr,
+    )
+    return "\n".join(output)
+
+
+def convert_font(arguments, image):
+    bits = to_bits(image, arguments.threshold, arguments.dither, arguments.invert)
+    width, height = arguments.glyph
+    if height > PAGE_HEIGHT:
+        raise ValueError("Glyphs can be up to %d pixels tall" % PAGE_HEIGHT)
+    glyphs = [to_pages(glyph) for glyph in slice_sprites(bits, arguments.glyph)]
+    codes = [arguments.first + index for index in range(len(glyphs))]
+    if arguments.chars is not None:
+        wanted = set(ord(character) for character in arguments.chars)
+        missing = wanted - set(codes)
+        if missing:
+            raise ValueError(
+                "No glyphs for %s" % "".join(sorted(chr(code) for code in missing))
+            )
+        kept = [index for index, code in enumerate(codes) if code in wanted]
+        glyphs = [glyphs[index] for index in kept]
+        codes = [codes[index] for index in kept]
+    if (
+        arguments.packed
+        or arguments.chars is not None
+        or arguments.fallback is not None
+    ):
+        return convert_packed_font(arguments, glyphs, codes)
+    namespace = "%s_LCD_Fonts" % arguments.name
+    font = "%sFont" % arguments.name
+
+    table = []
+    for index, glyph in enumerate(glyphs):
+        code = arguments.first + index
+        # A backslash would continue the comment on the next line
+        printable = 0x20 < code < 0x7F and code != ord("\\")
+        character = chr(code) if printable else "0x%02x" % code
+        table.append(
+            "        {%s}, // %s" % (",".join("0x%02x" % b for b in glyph), character)
+        )
+    widths = glyph_widths(glyphs, width)
+
+    output = font_preamble(arguments)
+    output.extend([
+        "namespace %s {" % namespace,
+        "    const uint8_t kColumns_per_character = %d;" % width,
+        "    const uint8_t kFirst_character = 0x%02x;" % arguments.first,
+        "    const unsigned char hSpace[] = {%s};"
+        % ",".join(["0x00"] * max(1, arguments.spacing)),
+        "    const unsigned char hSpaceSize = %d;" % arguments.spacing,
+        "",
+        "    /* Font table:",
+        "    Each byte in a row represents one, 8-pixel, vertical column of a",
+        "    character. %d bytes per character. */" % width,
+        "    const unsigned char kFont_Table[][kColumns_per_character] PROGMEM = {",
+    ])
+    output.extend(table)
+    output.append("    };")
+    output.append("")
+    flash = len(glyphs) * width
+    if arguments.proportional:
+        output.extend(
+            [
+                "    const uint8_t kWidths[] PROGMEM = {",
+                c_array(widths, "        "),
+                "    };",
+                "",
+            ]
+        )
+        flash += len(widths)
+    output.extend(
+        [
+            "    const LcdFont %s {" % font,
+            "        [](char c) { return kFont_Table[static_cast<uint8_t>(c) - kFirst_character]; },",
+            "        kColumns_per_character,",
+            "        hSpace,",
+            "        hSpaceSize%s" % ("," if arguments.proportional else ""),
+        ]
+    )
+    if arguments.proportional:
+        output.append(
+            "        [](char c) { return nokia_lcd::readFlashByte("
+            "kWidths + static_cast<uint8_t>(c) - kFirst_character); }"
+        )
+    output.extend(["    };", "", "}  // namespace %s" % namespace, ""])
+
+    print("%d glyphs, %d bytes of flash" % (len(glyphs), flash), file=sys.stderr)
+    return "\n".join(output)
+
+
+def size(text):
+    match = re.fullmatch(r"(\d+)x(\d+)", text)
+    if not match:
+        raise argparse.ArgumentTypeError("expected WIDTHxHEIGHT, e.g. 5x8")
+    return int(match.group(1)), int(match.group(2))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    commands = parser.add_subparsers(dest="command")
+    commands.required = True
+
+    image_parser = commands.add_parser("image", help="convert a bitmap")
+    image_parser.add_argument("--crop", action="store_true",
+                              help="leave out the blank margins")
+    image_parser.add_argument("--sprite", type=size,
+                              help="slice a sprite sheet into WxH bitmaps")
+    image_parser.add_argument("--rle", action="store_true",
+                              help="compress with run-length encoding")
+    image_parser.set_defaults(convert=convert_image)
+
+    font_parser = commands.add_parser("font", help="convert a grid of glyphs")
+    font_parser.add_argument("--glyph", type=size, required=True,
+                             help="the size of every glyph, e.g. 5x8")
+    font_parser.add_argument("--first", type=lambda text: int(text, 0),
+                             default=0x20, help="the first character")
+    font_parser.add_argument("--spacing", type=int, default=1,
+                             help="blank columns between the characters")
+    font_parser.add_argument("--proportional", action="store_true",
+                             help="draw each glyph only as wide as it is")
+    font_parser.add_argument("--packed", action="store_true",
+                             help="store only the rows in use, bit by bit")
+    font_parser.add_argument("--chars",
+                             help="keep only these characters, implies "
+                             "--packed")
+    font_parser.add_argument("--fallback",
+                             help="the character shown for missing ones, "
+                             "implies --packed")
+    font_parser.set_defaults(convert=convert_font)
+
+    for subparser in (image_parser, font_parser):
+        subparser.add_argument("image")
+        subparser.add_argument("--name", help="the name of the C++ result")
+        subparser.add_argument("--threshold", type=int, default=128,
+                               help="gray levels below it are drawn")
+        subparser.add_argument("--dither", action="store_true",
+                               help="use Floyd-Steinberg dithering")
+        subparser.add_argument("--invert", action="store_true",
+                               help="draw the light pixels instead")
+        subparser.add_argument("-o", "--output",
+                               help="the header to write, else standard output")
+
+    arguments = parser.parse_args()
+    if not arguments.name:
+        arguments.name = identifier(
+            os.path.splitext(os.path.basename(arguments.image))[0]
+        )
+    header = arguments.convert(arguments, Image.load(arguments.image))
+    if arguments.output:
+        with open(arguments.output, "w") as output:
+            output.write(header)
+    else:
+        sys.stdout.write(header)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,268 @@
+#!/usr/bin/env python3
+"""
+Replays the traces recorded with `Nokia_LCD::exportTrace()` on an emulated
+PCD8544 controller, the one driving the Nokia 5110 LCD.
+
+Useful to make sure that a change to a sketch (or to the library) leaves what
+is shown on the screen untouched, while checking how much traffic it needs.
+
+Usage:
+    nokia_lcd_trace.py stats TRACE
+    nokia_lcd_trace.py render TRACE IMAGE [--scale N]
+    nokia_lcd_trace.py diff TRACE_A TRACE_B [--image IMAGE] [--scale N]
+
+Images are written as PNG, unless their name ends with `.pbm`. The `diff`
+command exits with 1 when the two traces result in different screens.
+Only the Python standard library is needed.
+"""
+import argparse
+import struct
+import sys
+import zlib
+
+WIDTH = 84
+HEIGHT = 48
+ROWS = HEIGHT // 8
+
+MAGIC = b"NLTR"
+VERSION = 1
+TRACE_DATA = 0x01
+TRACE_CE = 0x02
+
+
+class Trace:
+    """The entries of a trace and the number of entries lost before them"""
+
+    def __init__(self, entries, dropped):
+        self.entries = entries
+        self.dropped = dropped
+
+    @staticmethod
+    def load(path):
+        with open(path, "rb") as trace_file:
+            content = trace_file.read()
+        # Serial monitors may have captured some text before the trace
+        start = content.find(MAGIC)
+        if start < 0:
+            raise ValueError("%s does not contain a trace" % path)
+        version, size, dropped = struct.unpack_from("<BHH", content, start + 4)
+        if version != VERSION:
+            raise ValueError("Unsupported trace version %d" % version)
+        first = start + 9
+        if len(content) < first + size * 2:
+            raise ValueError("%s is truncated" % path)
+        entries = [
+            (content[first + i * 2], content[first + i * 2 + 1]) for i in range(size)
+        ]
+
+        return Trace(entries, dropped)
+
+
+class Pcd8544:
+    """The parts of the PCD8544 controller that affect what is displayed"""
+
+    def __init__(self):
+        self.ram = [[0] * WIDTH for _ in range(ROWS)]
+        self.x = 0
+        self.y = 0
+        self.extended = False
+        self.vertical = False
+        self.power_down = True
+        self.display_control = 0
+        self.contrast = 0
+        self.bias = 0
+        self.temperature_coefficient = 0
+        self.selected = True
+        self.counts = {"commands": 0, "data": 0, "ce": 0, "ignored": 0}
+
+    def replay(self, trace):
+        # Bytes are only sent while selected, so the chip select level before
+        # the trace is the opposite of its first change
+        ce_changes = [value for flags, value in trace.entries if flags & TRACE_CE]
+        self.selected = not ce_changes or ce_changes[0] != 0
+        for flags, value in trace.entries:
+            if flags & TRACE_CE:
+                self.selected = value == 0
+                self.counts["ce"] += 1
+            elif not self.selected:
+                self.counts["ignored"] += 1
+            elif flags & TRACE_DATA:
+                self.write(value)
+            else:
+                self.command(value)
+
+    def command(self, command):
+        self.counts["commands"] += 1
+        if command & 0xF8 == 0x20:
+            self.power_down = bool(command & 0x04)
+            self.vertical = bool(command & 0x02)
+            self.extended = bool(command & 0x01)
+        elif self.extended:
+            if command & 0x80:
+                self.contrast = command & 0x7F
+            elif command & 0xF8 == 0x10:
+                self.bias = command & 0x07
+            elif command & 0xFC == 0x04:
+                self.temperature_coefficient = command & 0x03
+        elif command & 0x80:
+            if command & 0x7F < WIDTH:
+                self.x = command & 0x7F
+        elif command & 0xC0 == 0x40:
+            if command & 0x07 < ROWS:
+                self.y = command & 0x07
+        elif command & 0xF8 == 0x08:
+            self.display_control = command & 0x05
+
+    def write(self, data):
+        self.counts["data"] += 1
+        self.ram[self.y][self.x] = data
+        if self.vertical:
+            self.y += 1
+            if self.y == ROWS:
+                self.y = 0
+                self.x = (self.x + 1) % WIDTH
+        else:
+            self.x += 1
+            if self.x == WIDTH:
+                self.x = 0
+                self.y = (self.y + 1) % ROWS
+
+    def pixel(self, x, y):
+        """Whether the pixel is dark, taking the display mode into account"""
+        if self.power_down or self.display_control == 0x00:
+            return False
+        if self.display_control == 0x01:
+            return True
+        dark = bool(self.ram[y // 8][x] >> (y % 8) & 1)
+        return not dark if self.display_control == 0x05 else dark
+
+
+def pixels(display):
+    return [[display.pixel(x, y) for x in range(WIDTH)] for y in range(HEIGHT)]
+
+
+def save_image(path, image, scale):
+    """Saves rows of booleans (True is black) as a PBM or a PNG"""
+    rows = [[value for value in row for _ in range(scale)] for row in image]
+    rows = [row for row in rows for _ in range(scale)]
+    width = len(rows[0])
+    # Both formats pack 8 pixels per byte, most significant bit first
+    packed = []
+    for row in rows:
+        line = bytearray((width + 7) // 8)
+        for x, value in enumerate(row):
+            if value:
+                line[x // 8] |= 0x80 >> (x % 8)
+        packed.append(bytes(line))
+
+    with open(path, "wb") as image_file:
+        if path.lower().endswith(".pbm"):
+            image_file.write(b"P4\n%d %d\n" % (width, len(rows)))
+            image_file.write(b"".join(packed))
+            return
+
+        def chunk(kind, content):
+            return (
+                struct.pack(">I", len(content))
+                + kind
+                + content
+                + struct.pack(">I", zlib.crc32(kind + content) & 0xFFFFFFFF)
+            )
+
+        # A 1-bit grayscale PNG, where 0 is black
+        header = struct.pack(">IIBBBBB", width, len(rows), 1, 0, 0, 0, 0)
+        inverted = [bytes(~b & 0xFF for b in line) for line in packed]
+        scanlines = b"".join(b"\x00" + line for line in inverted)
+        image_file.write(b"\x89PNG\r\n\x1a\n")
+        image_file.write(chunk(b"IHDR", header))
+        image_file.write(chunk(b"IDAT", zlib.compress(scanlines, 9)))
+        image_file.write(chunk(b"IEND", b""))
+
+
+def replay(path):
+    trace = Trace.load(path)
+    if trace.dropped:
+        print(
+            "%s: %d entries were overwritten, the screen before them is "
+            "assumed blank" % (path, trace.dropped),
+            file=sys.stderr,
+        )
+    display = Pcd8544()
+    display.replay(trace)
+
+    return display
+
+
+def print_counts(name, display):
+    counts = display.counts
+    print(
+        "%s: %d commands, %d data bytes, %d CE changes, %d bytes while "
+        "deselected" % (name, counts["commands"], counts["data"], counts["ce"],
+                        counts["ignored"])
+    )
+
+
+def stats(arguments):
+    print_counts(arguments.trace, replay(arguments.trace))
+
+    return 0
+
+
+def render(arguments):
+    save_image(arguments.image, pixels(replay(arguments.trace)), arguments.scale)
+
+    return 0
+
+
+def diff(arguments):
+    first = replay(arguments.trace_a)
+    second = replay(arguments.trace_b)
+    print_counts(arguments.trace_a, first)
+    print_counts(arguments.trace_b, second)
+    for kind in ("commands", "data", "ce"):
+        print(
+            "%s: %+d" % (kind, second.counts[kind] - first.counts[kind])
+        )
+
+    first_pixels = pixels(first)
+    second_pixels = pixels(second)
+    different = [
+        [first_pixels[y][x] != second_pixels[y][x] for x in range(WIDTH)]
+        for y in range(HEIGHT)
+    ]
+    count = sum(sum(row) for row in different)
+    print("pixels: %d different" % count)
+    if arguments.image:
+        save_image(arguments.image, different, arguments.scale)
+
+    return 1 if count else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[0])
+    commands = parser.add_subparsers(dest="command")
+    commands.required = True
+
+    stats_parser = commands.add_parser("stats", help="count what was sent")
+    stats_parser.add_argument("trace")
+    stats_parser.set_defaults(run=stats)
+
+    render_parser = commands.add_parser("render", help="draw the screen")
+    render_parser.add_argument("trace")
+    render_parser.add_argument("image")
+    render_parser.add_argument("--scale", type=int, default=4)
+    render_parser.set_defaults(run=render)
+
+    diff_parser = commands.add_parser("diff", help="compare two traces")
+    diff_parser.add_argument("trace_a")
+    diff_parser.add_argument("trace_b")
+    diff_parser.add_argument("--image", help="draw the different pixels")
+    diff_parser.add_argument("--scale", type=int, default=4)
+    diff_parser.set_defaults(run=diff)
+
+    arguments = parser.parse_args()
+    return arguments.run(arguments)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -10,8 +10,191 @@
  * On how to use this library, please refer to the `examples/` folder.`
  */
 #pragma once
+#include <stdint.h>
+
+#include "Nokia_LCD_Flash.h"
 
 using GetFontCallback = const unsigned char* (*)(char);
+using GetWidthCallback = uint8_t (*)(char);
+
+/**
+ * A run of consecutive code points of a packed font, whose glyphs are stored
+ * one after the other
+ */
+struct GlyphRange
+{
+    uint16_t first; // The first code point
+    uint16_t last;  // The last code point
+    uint16_t glyph; // The index of the glyph of the first code point
+};
+
+/**
+ * A font that stores only the rows its glyphs use, `height` bits of each
+ * column packed back to back, and only the glyphs of some code points, e.g.
+ * the digits and a few symbols. Create one with
+ * `extras/nokia_lcd_convert.py font --packed`.
+ */
+struct PackedFont
+{
+    const unsigned char* bitmap; // The columns of all glyphs, in flash
+    const uint16_t* columns;     // The first column of every glyph and the
+                                 // end of the last one, in flash, or nullptr
+                                 // if every glyph is `width` wide
+    const GlyphRange* ranges;    // Sorted by code point, in flash
+    uint8_t rangeCount;
+    uint8_t width;  // The width of every glyph, unless `columns` is set
+    uint8_t height; // The number of rows stored, 1 to 8
+    uint8_t top;    // The first row stored
+    uint16_t fallback; // Shown for missing code points, 0 for a blank glyph
+};
+
+/**
+ * The glyphs of code points beyond ASCII, e.g. of degrees, micro, umlauts or
+ * Greek letters, for a font made of 8-bit columns. Every glyph is as wide as
+ * the glyphs of the font.
+ */
+struct FontExtension
+{
+    const GlyphRange* ranges;    // Sorted by code point, in flash
+    uint8_t rangeCount;
+    const unsigned char* glyphs; // `columnSize` columns per glyph, in flash
+    uint16_t fallback; // Shown for missing code points, 0 for a blank glyph
+};
+
+/**
+ * Decodes UTF-8 text one byte at a time, so that it can be printed as it is
+ * written. Stray continuation bytes, code points beyond 0xFFFF and those that
+ * are encoded with more bytes than ASCII needs become `kInvalidCodePoint`,
+ * which is drawn with the fallback glyph. A sequence that is cut short by
+ * another character is dropped.
+ */
+class Utf8Decoder
+{
+public:
+    static const uint16_t kInvalidCodePoint = 0xFFFF;
+    Utf8Decoder()
+        : mCodePoint{ 0 }
+        , mPending{ 0 }
+    {
+    }
+    /**
+     * Feeds the next byte of the text. Returns true if it completes a code
+     * point, which is then stored in `codePoint`.
+     */
+    bool decode(unsigned char byte, uint16_t& codePoint)
+    {
+        if (byte < 0x80) {
+            mPending = 0;
+            codePoint = byte;
+            return true;
+        }
+        if (byte < 0xC0) {
+            // A continuation byte, which carries 6 more bits
+            if (mPending == 0) {
+                codePoint = kInvalidCodePoint;
+                return true;
+            }
+            if (mCodePoint != kInvalidCodePoint) {
+                mCodePoint = mCodePoint << 6 | (byte & 0x3F);
+            }
+            if (--mPending > 0) {
+                return false;
+            }
+            codePoint = mCodePoint;
+            if (codePoint < 0x80) {
+                codePoint = kInvalidCodePoint;
+            }
+            return true;
+        }
+        // A lead byte, which tells how many continuation bytes follow
+        if (byte < 0xE0) {
+            mCodePoint = byte & 0x1F;
+            mPending = 1;
+        } else if (byte < 0xF0) {
+            mCodePoint = byte & 0x0F;
+            mPending = 2;
+        } else if (byte < 0xF8) {
+            mCodePoint = kInvalidCodePoint;
+            mPending = 3;
+        } else {
+            mPending = 0;
+            codePoint = kInvalidCodePoint;
+            return true;
+        }
+        return false;
+    }
+    /**
+     * Returns whether the bytes fed so far end in the middle of a sequence
+     */
+    bool isPending() const
+    {
+        return mPending > 0;
+    }
+private:
+    uint16_t mCodePoint;
+    uint8_t mPending; // The continuation bytes still expected
+};
+
+/**
+ * The columns of a single glyph, unpacked one at a time
+ */
+class LcdGlyph
+{
+public:
+    /**
+     * A glyph made of 8-bit columns, in flash
+     */
+    LcdGlyph(const unsigned char* columns, uint8_t width)
+        : width{ width }
+        , mData{ columns }
+        , mFirstColumn{ 0 }
+        , mHeight{ 0 }
+        , mTop{ 0 }
+    {
+    }
+    /**
+     * A glyph of a packed font, nullptr `bitmap` for a blank one
+     */
+    LcdGlyph(const unsigned char* bitmap,
+             uint16_t firstColumn,
+             uint8_t width,
+             uint8_t height,
+             uint8_t top)
+        : width{ width }
+        , mData{ bitmap }
+        , mFirstColumn{ firstColumn }
+        , mHeight{ height }
+        , mTop{ top }
+    {
+    }
+    /**
+     * Returns a column of the glyph as an 8-bit column for `draw()`
+     */
+    unsigned char getColumn(uint8_t column) const
+    {
+        if (mData == nullptr) {
+            return 0x00;
+        }
+        if (mHeight == 0) {
+            return nokia_lcd::readFlashByte(mData + column);
+        }
+        // The column may start in a byte and end in the next one
+        const uint16_t bit = (mFirstColumn + column) * mHeight;
+        const unsigned char* byte = mData + bit / 8;
+        const uint8_t shift = bit % 8;
+        unsigned int bits = nokia_lcd::readFlashByte(byte) >> shift;
+        if (shift + mHeight > 8) {
+            bits |= nokia_lcd::readFlashByte(byte + 1) << (8 - shift);
+        }
+        return (bits & ((1U << mHeight) - 1)) << mTop;
+    }
+    const uint8_t width;
+private:
+    const unsigned char* mData;
+    uint16_t mFirstColumn;
+    uint8_t mHeight; // 0 for whole 8-bit columns
+    uint8_t mTop;
+};
 
 class LcdFont
 {
@@ -19,20 +202,256 @@ public:
     LcdFont(GetFontCallback getFontCallback,
             uint8_t columnSize,
             const unsigned char* hSpace,
-            uint8_t hSpaceSize)
+            uint8_t hSpaceSize,
+            GetWidthCallback getWidthCallback = nullptr,
+            const FontExtension* extension = nullptr)
         : hSpace{ hSpace }
         , hSpaceSize{ hSpaceSize }
         , columnSize{ columnSize } 
         , mGetFontCallback{ getFontCallback }
+        , mGetWidthCallback{ getWidthCallback }
+        , mPackedFont{ nullptr }
+        , mExtension{ extension }
+    {
+    }
+    /**
+     * A packed font, see `PackedFont`
+     */
+    LcdFont(const PackedFont* packedFont,
+            const unsigned char* hSpace,
+            uint8_t hSpaceSize)
+        : hSpace{ hSpace }
+        , hSpaceSize{ hSpaceSize }
+        , columnSize{ packedFont->width }
+        , mGetFontCallback{ nullptr }
+        , mGetWidthCallback{ nullptr }
+        , mPackedFont{ packedFont }
+        , mExtension{ nullptr }
     {
     }
+    /**
+     * Returns the 8-bit columns of the glyph, or nullptr for packed fonts,
+     * whose glyphs are read with `getGlyph()`
+     */
     const unsigned char* getFont(char character) const
     {   
-        return mGetFontCallback(character);
+        return mGetFontCallback ? mGetFontCallback(character) : nullptr;
+    }
+    /**
+     * Returns how many columns of the glyph are drawn. Fonts with proportional
+     * widths supply a callback, otherwise every glyph is `columnSize` wide.
+     */
+    uint8_t getWidth(char character) const
+    {
+        if (mPackedFont) {
+            return getGlyph(character).width;
+        }
+        return mGetWidthCallback ? mGetWidthCallback(character) : columnSize;
+    }
+    /**
+     * Returns whether text is decoded from UTF-8 for the font, which is the
+     * case for packed fonts and fonts with an extension. Other fonts get every
+     * byte as it is, so that tables of 256 glyphs, e.g. of a code page, can
+     * be printed whole.
+     */
+    bool isUtf8() const
+    {
+        return mPackedFont || mExtension;
+    }
+    /**
+     * Feeds the next byte of the text, see `isUtf8()`. Returns true if it
+     * completes a code point, which is then stored in `codePoint`.
+     */
+    bool decode(Utf8Decoder& decoder,
+                unsigned char byte,
+                uint16_t& codePoint) const
+    {
+        if (!isUtf8()) {
+            codePoint = byte;
+            return true;
+        }
+        return decoder.decode(byte, codePoint);
+    }
+    /**
+     * Returns how many columns the glyph of a code point is drawn with
+     */
+    uint8_t getExtendedWidth(uint16_t codePoint) const
+    {
+        if (isByte(codePoint)) {
+            return getWidth(static_cast<char>(codePoint));
+        }
+        return getExtendedGlyph(codePoint).width;
     }
+    /**
+     * Returns the glyph of a character. Characters missing from a packed
+     * font are drawn with its fallback glyph.
+     */
+    LcdGlyph getGlyph(char character) const
+    {
+        if (!mPackedFont) {
+            return LcdGlyph(getFont(character), getWidth(character));
+        }
+        return getExtendedGlyph(static_cast<unsigned char>(character));
+    }
+    /**
+     * Returns the glyph of a code point, e.g. decoded from UTF-8. Code points
+     * beyond ASCII are looked up in the ranges of a packed font or of the
+     * extension of the font. Missing ones are drawn with the fallback glyph,
+     * or blank if there is none.
+     */
+    LcdGlyph getExtendedGlyph(uint16_t codePoint) const
+    {
+        uint16_t glyph;
+        uint16_t fallback = 0;
+        if (mPackedFont) {
+            if (findGlyph(mPackedFont->ranges, mPackedFont->rangeCount,
+                          codePoint, glyph)) {
+                return packedGlyph(glyph);
+            }
+            fallback = mPackedFont->fallback;
+        } else if (isByte(codePoint)) {
+            return getGlyph(static_cast<char>(codePoint));
+        } else if (mExtension) {
+            if (findGlyph(mExtension->ranges, mExtension->rangeCount,
+                          codePoint, glyph)) {
+                return LcdGlyph(mExtension->glyphs + glyph * columnSize,
+                                columnSize);
+            }
+            fallback = mExtension->fallback;
+        }
+        // The fallback glyph might be missing too
+        if (fallback != 0 && fallback != codePoint) {
+            return getExtendedGlyph(fallback);
+        }
+        return LcdGlyph(nullptr, 0, columnSize, 0, 0);
+    }
+    /**
+     * Returns the position of a code point beyond ASCII among the ones the
+     * font has glyphs for, so that it can be kept in a single byte, e.g. by
+     * the console. Only the first 127 of them have a position.
+     * @return The position, or `kNoIndex` if the code point has none
+     */
+    uint8_t getExtendedIndex(uint16_t codePoint) const
+    {
+        const GlyphRange* ranges;
+        uint8_t rangeCount;
+        getRanges(ranges, rangeCount);
+        uint16_t index = 0;
+        for (uint8_t i = 0; i < rangeCount && index < kNoIndex; i++) {
+            uint16_t first = nokia_lcd::readFlashWord(&ranges[i].first);
+            const uint16_t last = nokia_lcd::readFlashWord(&ranges[i].last);
+            first = first < 0x80 ? 0x80 : first;
+            if (last < first) {
+                continue;
+            }
+            if (codePoint >= first && codePoint <= last) {
+                index += codePoint - first;
+                return index < kNoIndex ? index : kNoIndex;
+            }
+            index += last - first + 1;
+        }
+        return kNoIndex;
+    }
+    /**
+     * Returns the code point at a position, see `getExtendedIndex()`
+     * @return The code point, or `Utf8Decoder::kInvalidCodePoint` if there is
+     *         none at the position
+     */
+    uint16_t getIndexedCodePoint(uint8_t index) const
+    {
+        if (index >= kNoIndex) {
+            return Utf8Decoder::kInvalidCodePoint;
+        }
+        const GlyphRange* ranges;
+        uint8_t rangeCount;
+        getRanges(ranges, rangeCount);
+        for (uint8_t i = 0; i < rangeCount; i++) {
+            uint16_t first = nokia_lcd::readFlashWord(&ranges[i].first);
+            const uint16_t last = nokia_lcd::readFlashWord(&ranges[i].last);
+            first = first < 0x80 ? 0x80 : first;
+            if (last < first) {
+                continue;
+            }
+            if (index <= last - first) {
+                return first + index;
+            }
+            index -= last - first + 1;
+        }
+        return Utf8Decoder::kInvalidCodePoint;
+    }
+    static const uint8_t kNoIndex = 127;
     const unsigned char* const hSpace;
     const uint8_t hSpaceSize;
     const uint8_t columnSize;
 private:
+    /**
+     * Returns the ranges of code points of a packed font or of the extension,
+     * none for other fonts
+     */
+    void getRanges(const GlyphRange*& ranges, uint8_t& rangeCount) const
+    {
+        ranges = nullptr;
+        rangeCount = 0;
+        if (mPackedFont) {
+            ranges = mPackedFont->ranges;
+            rangeCount = mPackedFont->rangeCount;
+        } else if (mExtension) {
+            ranges = mExtension->ranges;
+            rangeCount = mExtension->rangeCount;
+        }
+    }
+    /**
+     * Returns whether the glyph of a code point is the one of a single byte,
+     * read through the callback of the font
+     */
+    bool isByte(uint16_t codePoint) const
+    {
+        return !mPackedFont
+            && (codePoint < 0x80 || (!mExtension && codePoint <= 0xFF));
+    }
+    /**
+     * Finds the glyph of a code point with a binary search of the ranges
+     */
+    static bool findGlyph(const GlyphRange* ranges,
+                          uint8_t rangeCount,
+                          uint16_t codePoint,
+                          uint16_t& glyph)
+    {
+        uint8_t low = 0;
+        uint8_t high = rangeCount;
+        while (low < high) {
+            const uint8_t middle = (low + high) / 2;
+            const uint16_t first
+                = nokia_lcd::readFlashWord(&ranges[middle].first);
+            const uint16_t last
+                = nokia_lcd::readFlashWord(&ranges[middle].last);
+            if (codePoint < first) {
+                high = middle;
+            } else if (codePoint > last) {
+                low = middle + 1;
+            } else {
+                glyph = nokia_lcd::readFlashWord(&ranges[middle].glyph)
+                        + codePoint - first;
+                return true;
+            }
+        }
+        return false;
+    }
+    LcdGlyph packedGlyph(uint16_t glyph) const
+    {
+        const PackedFont& font = *mPackedFont;
+        if (!font.columns) {
+            return LcdGlyph(font.bitmap, glyph * font.width, font.width,
+                            font.height, font.top);
+        }
+        const uint16_t first = nokia_lcd::readFlashWord(font.columns + glyph);
+        const uint16_t end
+            = nokia_lcd::readFlashWord(font.columns + glyph + 1);
+        return LcdGlyph(font.bitmap, first, end - first, font.height,
+                        font.top);
+    }
     const GetFontCallback mGetFontCallback;
+    const GetWidthCallback mGetWidthCallback;
+    const PackedFont* const mPackedFont;
+    const FontExtension* const mExtension;
 };
\ No newline at end of file
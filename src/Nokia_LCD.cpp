@@ -1,32 +1,213 @@
-// If we are not building for AVR architectures ignore PROGMEM
-#if __has_include(<avr/pgmspace.h>)
-#include <avr/pgmspace.h>
-#else
-#define PROGMEM
-#define pgm_read_byte_near *
-#endif
 #include <SPI.h>
-#include <math.h>
-#include <stdio.h>
+#include <string.h>
 
 #include "Nokia_LCD.h"
+#include "Nokia_LCD_Flash.h"
 #include "Nokia_LCD_Fonts.h"
 
 namespace {
-// Instantiate the default font
+// The glyphs of the default font, where control characters and DEL, which the
+// table does not cover, are drawn with the fallback glyph of the extension
+const unsigned char *defaultGlyph(char c) {
+    unsigned char character = c;
+    if (character < 0x20 || character >= 0x7F) {
+        character = Nokia_LCD_Fonts::kFallback;
+    }
+    return Nokia_LCD_Fonts::kDefault_font[character - 0x20];
+}
+
+// Instantiate the default font, with the glyphs beyond ASCII
+const FontExtension nokiaFontExtension{
+    Nokia_LCD_Fonts::kExtended_ranges,
+    sizeof(Nokia_LCD_Fonts::kExtended_ranges) / sizeof(GlyphRange),
+    Nokia_LCD_Fonts::kExtended_font[0], Nokia_LCD_Fonts::kFallback};
 const LcdFont nokiaFont{
-    [](char c) { return Nokia_LCD_Fonts::kDefault_font[c - 0x20]; },
-    Nokia_LCD_Fonts::kColumns_per_character, Nokia_LCD_Fonts::hSpace, 1};
+    defaultGlyph,
+    Nokia_LCD_Fonts::kColumns_per_character,
+    Nokia_LCD_Fonts::hSpace,
+    1,
+    nullptr,
+    &nokiaFontExtension};
+static_assert(nokia_lcd::kDefault_glyph_width ==
+                  Nokia_LCD_Fonts::kColumns_per_character,
+              "The default font metrics are out of sync");
 
 // Each row is made of 8-bit columns
-const unsigned int kTotal_rows =
-    nokia_lcd::kDisplay_max_height / Nokia_LCD_Fonts::kRows_per_character;
-const unsigned int kTotal_columns = nokia_lcd::kDisplay_max_width;
-const unsigned int kTotal_bits = nokia_lcd::kDisplay_max_width * kTotal_rows;
+constexpr unsigned int kTotal_rows = nokia_lcd::kDisplay_max_rows;
+constexpr unsigned int kTotal_columns = nokia_lcd::kDisplay_max_width;
+constexpr unsigned int kRows_per_page = Nokia_LCD_Fonts::kRows_per_character;
+constexpr unsigned int kTotal_bits = kTotal_columns * kTotal_rows;
+static_assert(nokia_lcd::kDisplay_max_height == kTotal_rows * kRows_per_page,
+              "Rows are as tall as the characters");
+// The address counter of the controller wraps around the 84x6 RAM of the
+// PCD8544, so it only moves on to the next row (or column) of the panel by
+// itself when the panel covers all of it
+constexpr bool kPanel_fills_ram = kTotal_columns == 84 && kTotal_rows == 6 &&
+                                  nokia_lcd::kDisplay_column_offset == 0;
+constexpr uint8_t kUnknown_address = 0xFF;
 const char kNull_char = '\0';
-const uint8_t kMax_number_length = 11;  // Size of unsigned long (10) + null
+const char kNew_line = '\n';
+const char kCarriage_return = '\r';
+const char kSpace = ' ';
+const char kEllipsis[] = "...";
+const unsigned char kBlank_column[] = {0x00};
+
+// Commands
+const uint8_t kFunction_set = 0x20;
+const uint8_t kExtended_instructions = 0x01;  // Function set flag
+const uint8_t kVertical_addressing = 0x02;    // Function set flag
+const uint8_t kPower_down = 0x04;             // Function set flag
+const uint8_t kSet_vop = 0x80;                // Extended instruction
+const uint8_t kSet_temperature_coefficient = 0x04;  // Extended instruction
+const uint8_t kSet_bias = 0x10;                     // Extended instruction
+
+const uint8_t kDisplay_normal = 0x0C;
+const int kMax_decimals = 9;  // Fit in an unsigned long
+const int kMax_base = 36;     // Digits and letters
+// The largest float below 2^32, above which `Print::printFloat` prints "ovf"
+const double kMax_printed_float = 4294967040.0;
+const uint8_t kDefault_decimals = 2;  // Of `%f`, like `print(double)`
+const char kFormat_escape = '%';
+
+// Returns how many digits a number is printed with
+uint8_t countDigits(unsigned long number, const uint8_t base) {
+    uint8_t digits = 1;
+    while (number >= base) {
+        number /= base;
+        digits++;
+    }
+
+    return digits;
+}
+
+// Reads the next character of a format, which may be stored in flash memory
+char readFormat(const char *&format, const bool read_from_progmem) {
+    const char character =
+        read_from_progmem ? nokia_lcd::readFlashByte(format) : *format;
+    format++;
+
+    return character;
+}
+
+// Returns what is printed instead of a number that does not fit in an
+// unsigned long, like `Print::printFloat` does, or nullptr if it fits
+const char *unprintableFloat(const double number) {
+    if (isnan(number)) {
+        return "nan";
+    }
+    if (isinf(number)) {
+        return "inf";
+    }
+    if (number > kMax_printed_float || number < -kMax_printed_float) {
+        return "ovf";
+    }
+
+    return nullptr;
+}
+
+// Splits a positive number, which `unprintableFloat()` accepts, into its
+// integral part and its decimals, rounded to the last decimal instead of
+// cutting the rest off
+void splitDecimals(double number, const uint8_t decimals,
+                   unsigned long &integral, unsigned long &fractional) {
+    unsigned long scale = 1;
+    for (uint8_t d = 0; d < decimals && d < kMax_decimals; d++) {
+        scale *= 10;
+    }
+    number += 0.5 / scale;
+    integral = static_cast<unsigned long>(number);
+    fractional = static_cast<unsigned long>((number - integral) * scale);
+}
 }  // namespace
 
+#ifdef NOKIA_LCD_ENABLE_STATS
+#define NOKIA_LCD_COUNT(counter) mStats.counter++
+#else
+#define NOKIA_LCD_COUNT(counter)
+#endif
+
+#ifdef NOKIA_LCD_ENABLE_ROTATION
+namespace {
+// The bits of every nibble in reverse order
+const unsigned char kReversed_nibbles[] PROGMEM = {
+    0x0, 0x8, 0x4, 0xC, 0x2, 0xA, 0x6, 0xE,
+    0x1, 0x9, 0x5, 0xD, 0x3, 0xB, 0x7, 0xF};
+
+unsigned char reverseBits(const unsigned char byte) {
+    return nokia_lcd::readFlashByte(kReversed_nibbles + (byte & 0x0F)) << 4 |
+           nokia_lcd::readFlashByte(kReversed_nibbles + (byte >> 4));
+}
+
+// Transposes an 8x8 bit matrix, so that bit `i` of `output[j]` is bit `j` of
+// `input[i]`, 4 bits, 2 bits and then 1 bit apart at a time
+void transpose(const unsigned char input[], unsigned char output[]) {
+    uint32_t x = static_cast<uint32_t>(input[7]) << 24 |
+                 static_cast<uint32_t>(input[6]) << 16 |
+                 static_cast<uint32_t>(input[5]) << 8 | input[4];
+    uint32_t y = static_cast<uint32_t>(input[3]) << 24 |
+                 static_cast<uint32_t>(input[2]) << 16 |
+                 static_cast<uint32_t>(input[1]) << 8 | input[0];
+    uint32_t t = (x ^ (x >> 7)) & 0x00AA00AA;
+    x = x ^ t ^ (t << 7);
+    t = (y ^ (y >> 7)) & 0x00AA00AA;
+    y = y ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC;
+    x = x ^ t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC;
+    y = y ^ t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+    output[7] = x >> 24;
+    output[6] = x >> 16;
+    output[5] = x >> 8;
+    output[4] = x;
+    output[3] = y >> 24;
+    output[2] = y >> 16;
+    output[1] = y >> 8;
+    output[0] = y;
+}
+}  // namespace
+#endif
+
+#ifdef NOKIA_LCD_ENABLE_TRACE
+#define NOKIA_LCD_RECORD(flags, value) record(flags, value)
+#else
+#define NOKIA_LCD_RECORD(flags, value)
+#endif
+
+nokia_lcd::TextSize nokia_lcd::measureText(const char *string,
+                                           const LcdFont *font) {
+    TextSize size{0, 0};
+    uint16_t line_width = 0;
+    bool line_is_empty = true;
+    Utf8Decoder decoder;
+    uint16_t code_point;
+    for (; *string != kNull_char; string++) {
+        if (!font->decode(decoder, *string, code_point)) {
+            continue;
+        }
+        if (*string == kNew_line) {
+            size.lines++;
+            line_width = 0;
+            line_is_empty = true;
+            continue;
+        }
+        // The spacing after the last glyph of a line is not counted
+        line_width += line_is_empty ? 0 : font->hSpaceSize;
+        line_width += font->getExtendedWidth(code_point);
+        line_is_empty = false;
+        if (line_width > size.width) {
+            size.width = line_width;
+        }
+    }
+    if (!line_is_empty) {
+        size.lines++;
+    }
+
+    return size;
+}
+
 Nokia_LCD::Nokia_LCD(const uint8_t clk_pin, const uint8_t din_pin,
                      const uint8_t dc_pin, const uint8_t ce_pin,
                      const uint8_t rst_pin)
@@ -40,7 +221,14 @@ Nokia_LCD::Nokia_LCD(const uint8_t clk_pin, const uint8_t din_pin,
       kUsingHardwareSPI{false},
       mX_cursor{0},
       mY_cursor{0},
-      mCurrentFont{&nokiaFont} {}
+      mCurrentFont{&nokiaFont},
+      mContrast{nokia_lcd::kDefault_init_profile.contrast},
+      mTemperatureCoefficient{
+          nokia_lcd::kDefault_init_profile.temperature_coefficient},
+      mBias{nokia_lcd::kDefault_init_profile.bias},
+      mDisplayControl{kDisplay_normal},
+      mVertical_addressing{false},
+      mPowered_down{false} {}
 
 Nokia_LCD::Nokia_LCD(const uint8_t dc_pin, const uint8_t ce_pin,
                      const uint8_t rst_pin)
@@ -54,7 +242,14 @@ Nokia_LCD::Nokia_LCD(const uint8_t dc_pin, const uint8_t ce_pin,
       kUsingHardwareSPI{true},
       mX_cursor{0},
       mY_cursor{0},
-      mCurrentFont{&nokiaFont} {}
+      mCurrentFont{&nokiaFont},
+      mContrast{nokia_lcd::kDefault_init_profile.contrast},
+      mTemperatureCoefficient{
+          nokia_lcd::kDefault_init_profile.temperature_coefficient},
+      mBias{nokia_lcd::kDefault_init_profile.bias},
+      mDisplayControl{kDisplay_normal},
+      mVertical_addressing{false},
+      mPowered_down{false} {}
 
 Nokia_LCD::Nokia_LCD(const uint8_t clk_pin, const uint8_t din_pin,
                      const uint8_t dc_pin, const uint8_t ce_pin,
@@ -69,7 +264,14 @@ Nokia_LCD::Nokia_LCD(const uint8_t clk_pin, const uint8_t din_pin,
       kUsingHardwareSPI{false},
       mX_cursor{0},
       mY_cursor{0},
-      mCurrentFont{&nokiaFont} {}
+      mCurrentFont{&nokiaFont},
+      mContrast{nokia_lcd::kDefault_init_profile.contrast},
+      mTemperatureCoefficient{
+          nokia_lcd::kDefault_init_profile.temperature_coefficient},
+      mBias{nokia_lcd::kDefault_init_profile.bias},
+      mDisplayControl{kDisplay_normal},
+      mVertical_addressing{false},
+      mPowered_down{false} {}
 
 Nokia_LCD::Nokia_LCD(const uint8_t dc_pin, const uint8_t ce_pin,
                      const uint8_t rst_pin, const uint8_t bl_pin)
@@ -83,9 +285,18 @@ Nokia_LCD::Nokia_LCD(const uint8_t dc_pin, const uint8_t ce_pin,
       kUsingHardwareSPI{true},
       mX_cursor{0},
       mY_cursor{0},
-      mCurrentFont{&nokiaFont} {}
-
-void Nokia_LCD::begin() {
+      mCurrentFont{&nokiaFont},
+      mContrast{nokia_lcd::kDefault_init_profile.contrast},
+      mTemperatureCoefficient{
+          nokia_lcd::kDefault_init_profile.temperature_coefficient},
+      mBias{nokia_lcd::kDefault_init_profile.bias},
+      mDisplayControl{kDisplay_normal},
+      mVertical_addressing{false},
+      mPowered_down{false} {}
+
+void Nokia_LCD::begin() { begin(nokia_lcd::kDefault_init_profile); }
+
+void Nokia_LCD::begin(const nokia_lcd::InitProfile &profile) {
     pinMode(kClk_pin, OUTPUT);
     pinMode(kDin_pin, OUTPUT);
     pinMode(kDc_pin, OUTPUT);
@@ -103,28 +314,203 @@ void Nokia_LCD::begin() {
         SPI.begin();
     }
 
-    sendCommand(0x21);  // Tell LCD extended commands follow
-    sendCommand(0xB0);  // Set LCD Vop (Contrast)
-    sendCommand(0x04);  // Set Temp coefficent
-    sendCommand(0x14);  // LCD bias mode 1:48 (try 0x13)
-    // We must send 0x20 before modifying the display control mode
-    sendCommand(0x20);
-    sendCommand(0x0C);  // Set display control, normal mode.
+    mContrast = profile.contrast;
+    mTemperatureCoefficient = profile.temperature_coefficient;
+    mBias = profile.bias;
+    mDisplayControl = kDisplay_normal;
+    // Everything but `drawColumns()` relies on horizontal addressing
+    mVertical_addressing = false;
+    mPowered_down = false;
+    mX_cursor = 0;
+    mY_cursor = 0;
+    sendSettings();
+}
+
+void Nokia_LCD::sleep() {
+    // Every later function set has to keep the display powered down too
+    mPowered_down = true;
+    sendCommand(functionSet());
+}
+
+void Nokia_LCD::wake() {
+    // Leaving power-down keeps the display RAM, so there is nothing to redraw
+    mPowered_down = false;
+    sendSettings();
+}
+
+void Nokia_LCD::sendSettings() {
+    const unsigned char settings[] = {
+        // Tell LCD extended commands follow
+        functionSet(kExtended_instructions),
+        // Set LCD Vop (Contrast)
+        static_cast<unsigned char>(kSet_vop | mContrast),
+        static_cast<unsigned char>(kSet_temperature_coefficient |
+                                   mTemperatureCoefficient),
+        static_cast<unsigned char>(kSet_bias | mBias),  // LCD bias mode
+        // We must send the basic function set before modifying the display
+        // control mode
+        functionSet(),
+        mDisplayControl,  // Set display control
+    };
+    sendCommands(settings, sizeof(settings));
+}
+
+void Nokia_LCD::sendExtendedCommand(const unsigned char command) {
+    // Tell LCD that extended commands follow and switch back afterwards
+    const unsigned char commands[] = {functionSet(kExtended_instructions),
+                                      command, functionSet()};
+    sendCommands(commands, sizeof(commands));
+}
+
+unsigned char Nokia_LCD::functionSet(const uint8_t flags) {
+    return kFunction_set | (mVertical_addressing ? kVertical_addressing : 0) |
+           (mPowered_down ? kPower_down : 0) | flags;
 }
 
 void Nokia_LCD::couple() {
     digitalWrite(kCe_pin, LOW);
+    NOKIA_LCD_COUNT(ce_toggles);
+    NOKIA_LCD_RECORD(nokia_lcd::kTrace_ce, LOW);
     mCoupled = true;
 }
 void Nokia_LCD::uncouple() {
     digitalWrite(kCe_pin, HIGH);
+    NOKIA_LCD_COUNT(ce_toggles);
+    NOKIA_LCD_RECORD(nokia_lcd::kTrace_ce, HIGH);
     mCoupled = false;
 }
 
+void Nokia_LCD::beginTransfer() {
+    if (mTransferDepth++ > 0) {
+        return;
+    }
+
+    if (kUsingHardwareSPI) {
+        constexpr uint32_t kSPiClockSpeed{F_CPU / 4U};
+        SPI.beginTransaction(SPISettings{kSPiClockSpeed, MSBFIRST, SPI_MODE0});
+    }
+    if (!mCoupled) {
+        digitalWrite(kCe_pin, LOW);
+        NOKIA_LCD_COUNT(ce_toggles);
+        NOKIA_LCD_RECORD(nokia_lcd::kTrace_ce, LOW);
+    }
+    NOKIA_LCD_COUNT(transfers);
+    // Other instances may share the DC pin, so its state is only trusted
+    // while we are the ones holding the bus
+    mDataMode = kUnknown_data_mode;
+}
+
+void Nokia_LCD::endTransfer() {
+    if (mTransferDepth == 0) {
+        return;
+    }
+#ifdef NOKIA_LCD_ENABLE_ROTATION
+    // What was drawn rotated has to be on the display when the transfer ends
+    if (mTransferDepth == 1) {
+        flushTile();
+    }
+#endif
+    if (--mTransferDepth > 0) {
+        return;
+    }
+
+    if (!mCoupled) {
+        digitalWrite(kCe_pin, HIGH);
+        NOKIA_LCD_COUNT(ce_toggles);
+        NOKIA_LCD_RECORD(nokia_lcd::kTrace_ce, HIGH);
+    }
+    if (kUsingHardwareSPI) {
+        SPI.endTransaction();
+    }
+}
+
+#ifdef NOKIA_LCD_ENABLE_STATS
+const nokia_lcd::Stats &Nokia_LCD::getStats() { return mStats; }
+
+void Nokia_LCD::resetStats() { mStats = nokia_lcd::Stats{}; }
+
+void Nokia_LCD::printStats(Print &output) {
+    output.print(F("commands: "));
+    output.println(mStats.commands);
+    output.print(F("data bytes: "));
+    output.println(mStats.data_bytes);
+    output.print(F("transfers: "));
+    output.println(mStats.transfers);
+    output.print(F("CE toggles: "));
+    output.println(mStats.ce_toggles);
+    output.print(F("DC toggles: "));
+    output.println(mStats.dc_toggles);
+    output.print(F("cursor addressings: "));
+    output.println(mStats.cursor_addressings);
+    output.print(F("glyphs: "));
+    output.println(mStats.glyphs);
+    output.print(F("send us: "));
+    output.println(mStats.send_micros);
+}
+#endif
+
+#ifdef NOKIA_LCD_ENABLE_TRACE
+void Nokia_LCD::exportTrace(Print &output) {
+    const uint8_t header[] = {'N',
+                              'L',
+                              'T',
+                              'R',
+                              1,  // Version
+                              static_cast<uint8_t>(mTrace_size),
+                              static_cast<uint8_t>(mTrace_size >> 8),
+                              static_cast<uint8_t>(mTrace_dropped),
+                              static_cast<uint8_t>(mTrace_dropped >> 8)};
+    output.write(header, sizeof(header));
+    for (uint16_t i = 0; i < mTrace_size; i++) {
+        const nokia_lcd::TraceEntry &entry =
+            mTrace[(mTrace_start + i) % nokia_lcd::kTrace_capacity];
+        output.write(entry.flags);
+        output.write(entry.value);
+    }
+}
+
+void Nokia_LCD::clearTrace() {
+    mTrace_start = 0;
+    mTrace_size = 0;
+    mTrace_dropped = 0;
+}
+
+void Nokia_LCD::record(const uint8_t flags, const uint8_t value) {
+    if (mTrace_size < nokia_lcd::kTrace_capacity) {
+        mTrace[(mTrace_start + mTrace_size++) % nokia_lcd::kTrace_capacity] =
+            {flags, value};
+        return;
+    }
+    mTrace[mTrace_start] = {flags, value};
+    mTrace_start = (mTrace_start + 1) % nokia_lcd::kTrace_capacity;
+    if (mTrace_dropped < 0xFFFF) {
+        mTrace_dropped++;
+    }
+}
+#endif
+
+void Nokia_LCD::setDataMode(const bool is_data) {
+    if (mDataMode == is_data) {
+        return;
+    }
+    digitalWrite(kDc_pin, is_data);
+    NOKIA_LCD_COUNT(dc_toggles);
+    mDataMode = is_data;
+}
+
 void Nokia_LCD::setContrast(uint8_t contrast) {
-    sendCommand(0x21);             // Tell LCD that extended commands follow
-    sendCommand(0x80 | contrast);  // Set LCD Vop (Contrast)
-    sendCommand(0x20);             // Set display mode
+    mContrast = contrast;
+    sendExtendedCommand(kSet_vop | contrast);  // Set LCD Vop (Contrast)
+}
+
+void Nokia_LCD::setBias(uint8_t bias) {
+    mBias = bias;
+    sendExtendedCommand(kSet_bias | bias);
+}
+
+void Nokia_LCD::setTemperatureCoefficient(uint8_t coefficient) {
+    mTemperatureCoefficient = coefficient;
+    sendExtendedCommand(kSet_temperature_coefficient | coefficient);
 }
 
 void Nokia_LCD::setInverted(bool invert) { mInverted = invert; }
@@ -138,6 +524,8 @@ void Nokia_LCD::setFont(const LcdFont *font) {
 
 void Nokia_LCD::setDefaultFont() { mCurrentFont = &nokiaFont; }
 
+const LcdFont *Nokia_LCD::getFont() { return mCurrentFont; }
+
 void Nokia_LCD::setBacklight(bool enabled) {
     if (!kUsingBacklight) {
         return;
@@ -146,30 +534,62 @@ void Nokia_LCD::setBacklight(bool enabled) {
 }
 
 bool Nokia_LCD::setCursor(uint8_t x, uint8_t y) {
-    if (x >= nokia_lcd::kDisplay_max_width || y >= kTotal_rows) {
+    if (x >= columns() || y >= rows()) {
         return false;
     }
 
     mX_cursor = x;
     mY_cursor = y;
-    sendCommand(0x80 | x);  // Column
-    sendCommand(0x40 | y);  // Row
+#ifdef NOKIA_LCD_ENABLE_ROTATION
+    if (mRotated) {
+        // The display is addressed when the rotated bytes are sent
+        return true;
+    }
+#endif
+    addressDisplay(x, y);
 
     return true;
 }
 
+void Nokia_LCD::addressDisplay(const uint8_t x, const uint8_t y) {
+    NOKIA_LCD_COUNT(cursor_addressings);
+    sendCommand(0x80 | (x + nokia_lcd::kDisplay_column_offset));  // Column
+    sendCommand(0x40 | y);  // Row
+}
+
 uint8_t Nokia_LCD::getCursorX() { return mX_cursor; }
 
 uint8_t Nokia_LCD::getCursorY() { return mY_cursor; }
 
 void Nokia_LCD::clear(bool is_black) {
-    setCursor(0, 0);
     unsigned char color = is_black ? 255 : 0;
+#ifdef NOKIA_LCD_ENABLE_ROTATION
+    if (mRotated) {
+        // The whole display looks the same in any rotation
+        beginTransfer();
+        mTile_x = kNo_tile;
+        mTile_dirty = false;
+        for (uint8_t page = 0; page < kTotal_rows; page++) {
+            if (page == 0 || !kPanel_fills_ram) {
+                addressDisplay(0, page);
+            }
+            for (uint8_t x = 0; x < kTotal_columns; x++) {
+                transmitTo(color, x, page);
+            }
+        }
+        setCursor(0, 0);
+        endTransfer();
+        return;
+    }
+#endif
+    setCursor(0, 0);
 
+    beginTransfer();
     for (unsigned int i = 0; i < kTotal_bits; i++) {
         sendData(color);
     }
     setCursor(0, 0);
+    endTransfer();
 }
 
 bool Nokia_LCD::println(const char *string) {
@@ -182,14 +602,75 @@ bool Nokia_LCD::print(const char *string) {
     unsigned int index = 0;
 
     bool out_of_bounds = false;
+    beginTransfer();
     while (*(string + index) != kNull_char) {
         unsigned char character = *(string + index++);
         out_of_bounds = printCharacter(character) || out_of_bounds;
     }
+    endTransfer();
+
+    return out_of_bounds;
+}
+
+bool Nokia_LCD::print(const char *string, const uint8_t anchor_x,
+                      const nokia_lcd::Alignment alignment) {
+    bool out_of_bounds = false;
+    beginTransfer();
+    while (true) {
+        // Measure the line, then move to where it has to start
+        const char *end = string;
+        unsigned int width = 0;
+        Utf8Decoder decoder;
+        uint16_t code_point;
+        while (*end != kNull_char && *end != kNew_line) {
+            if (mCurrentFont->decode(decoder, *end++, code_point)) {
+                width += mCurrentFont->getExtendedWidth(code_point) +
+                         mCurrentFont->hSpaceSize;
+            }
+        }
+        width -= width > 0 ? mCurrentFont->hSpaceSize : 0;
+
+        int x = anchor_x;
+        if (alignment == nokia_lcd::Alignment::kCenter) {
+            x -= width / 2;
+        } else if (alignment == nokia_lcd::Alignment::kRight) {
+            x -= width;
+        }
+        // The columns that would be left of the screen are not drawn
+        unsigned int hidden = 0;
+        if (x < 0) {
+            hidden = -x;
+            x = 0;
+            out_of_bounds = true;
+        }
+        setCursor(x, mY_cursor);
+
+        // Aligned text is cut at the edge of the screen instead of wrapping
+        uint8_t remaining = columns() - x;
+        decoder = Utf8Decoder();
+        while (string != end) {
+            if (mCurrentFont->decode(decoder, *string++, code_point)) {
+                out_of_bounds = out_of_bounds || remaining == 0;
+                printClipped(code_point, hidden, remaining);
+            }
+        }
+        if (*string == kNull_char) {
+            break;
+        }
+        out_of_bounds = printCharacter(*string++) || out_of_bounds;
+    }
+    endTransfer();
 
     return out_of_bounds;
 }
 
+bool Nokia_LCD::println(const char *string, const uint8_t anchor_x,
+                        const nokia_lcd::Alignment alignment) {
+    bool out_of_bounds = print(string, anchor_x, alignment);
+
+    return print("\n") || out_of_bounds;
+}
+
 #ifdef STRING_CLASS_IS_IMPLEMENTED
 bool Nokia_LCD::print(const String &string) {
     bool out_of_bounds = false;
@@ -207,6 +688,60 @@ bool Nokia_LCD::println(const String &string) {
 }
 #endif
 
+bool Nokia_LCD::print(const __FlashStringHelper *string) {
+    const char *flash_string = reinterpret_cast<const char *>(string);
+
+    bool out_of_bounds = false;
+    beginTransfer();
+    char character = nokia_lcd::readFlashByte(flash_string++);
+    while (character != kNull_char) {
+        out_of_bounds = printCharacter(character) || out_of_bounds;
+        character = nokia_lcd::readFlashByte(flash_string++);
+    }
+    endTransfer();
+
+    return out_of_bounds;
+}
+
+bool Nokia_LCD::println(const __FlashStringHelper *string) {
+    bool out_of_bounds = print(string);
+
+    return print("\n") || out_of_bounds;
+}
+
+size_t Nokia_LCD::print(const Printable &printable) {
+    beginTransfer();
+    size_t printed = printable.printTo(*this);
+    endTransfer();
+
+    return printed;
+}
+
+size_t Nokia_LCD::println(const Printable &printable) {
+    size_t printed = print(printable);
+    print("\n");
+
+    return printed + 1;
+}
+
+bool Nokia_LCD::println() { return print("\n"); }
+
+size_t Nokia_LCD::write(uint8_t character) {
+    printCharacter(character);
+
+    return 1;
+}
+
+size_t Nokia_LCD::write(const uint8_t *buffer, size_t size) {
+    beginTransfer();
+    for (size_t i = 0; i < size; i++) {
+        printCharacter(buffer[i]);
+    }
+    endTransfer();
+
+    return size;
+}
+
 bool Nokia_LCD::println(char character) {
     bool out_of_bounds = print(character);
 
@@ -218,48 +753,352 @@ bool Nokia_LCD::print(char character) { return printCharacter(character); }
 bool Nokia_LCD::printCharacter(char character) {
     const unsigned char new_line = '\n';
 
+    // Anything beyond ASCII is decoded from UTF-8 first, if the font does so
+    uint16_t code_point = static_cast<unsigned char>(character);
+    if (code_point >= 0x80 || mDecoder.isPending()) {
+        if (!mCurrentFont->decode(mDecoder, character, code_point)) {
+            return false;
+        }
+        if (code_point >= 0x80) {
+            return printGlyph(mCurrentFont->getExtendedGlyph(code_point));
+        }
+    }
+
     // If there is a new line character, we only need to change row
     if (character == new_line) {
         mX_cursor = 0;  // Go back to the beginning of the columns
-        mY_cursor = (mY_cursor + 1) % kTotal_rows;
+        mY_cursor = mY_cursor + 1U < rows() ? mY_cursor + 1 : 0;
         setCursor(mX_cursor, mY_cursor);  // Set the new cursor position
 
         // If we went back to row 0, return an out-of-bounds error
         return mY_cursor == 0;
     }
+    // Line endings written through `Print` are "\r\n", the new line suffices
+    if (character == kCarriage_return) {
+        return false;
+    }
 
-    bool out_of_bounds =
-        draw(mCurrentFont->getFont(character), mCurrentFont->columnSize, true);
+    return printGlyph(mCurrentFont->getGlyph(character));
+}
+
+bool Nokia_LCD::printGlyph(const LcdGlyph &glyph) {
+    NOKIA_LCD_COUNT(glyphs);
+    // The glyph and its spacing are sent as a single burst
+    beginTransfer();
+    bool out_of_bounds = drawGlyph(glyph, glyph.width);
     // Separate the characters with a vertical line so they don't appear too
     // close to each other
-    return draw(mCurrentFont->hSpace, mCurrentFont->hSpaceSize, false) ||
-           out_of_bounds;
+    out_of_bounds =
+        draw(mCurrentFont->hSpace, mCurrentFont->hSpaceSize, false) ||
+        out_of_bounds;
+    endTransfer();
+
+    return out_of_bounds;
+}
+
+bool Nokia_LCD::printInBox(const uint8_t x, const uint8_t page, uint8_t width,
+                           uint8_t pages, const char *string,
+                           const nokia_lcd::Alignment alignment) {
+    if (x >= columns() || page >= rows()) {
+        return true;
+    }
+    // Shrink a box that does not fit on the screen
+    bool did_not_fit = false;
+    if (x + width > columns()) {
+        width = columns() - x;
+        did_not_fit = true;
+    }
+    if (page + pages > rows()) {
+        pages = rows() - page;
+        did_not_fit = true;
+    }
+
+    const uint8_t spacing = mCurrentFont->hSpaceSize;
+    const unsigned int ellipsis_width =
+        3 * (mCurrentFont->getWidth('.') + spacing) - spacing;
+
+    beginTransfer();
+    for (uint8_t line = 0; line < pages; line++) {
+        // Measure in a single pass how much of the text fits on this line.
+        // The spacing after the last character of a line may be left out.
+        const char *end = string;
+        unsigned int used = 0;        // Columns including trailing spacing
+        unsigned int line_width = 0;  // Columns without trailing spacing
+        const char *word_end = nullptr;
+        unsigned int word_width = 0;
+        const char *ellipsis_end = string;
+        unsigned int ellipsis_line_width = 0;
+        // A glyph may be made of several bytes of UTF-8
+        Utf8Decoder decoder;
+        uint16_t code_point;
+        const char *glyph_start = end;
+        const char *glyph_end = end;
+        while (*end != kNull_char && *end != kNew_line) {
+            if (!mCurrentFont->decode(decoder, *end++, code_point)) {
+                continue;
+            }
+            const uint8_t glyph_width =
+                mCurrentFont->getExtendedWidth(code_point);
+            if (used + glyph_width > width) {
+                glyph_end = end;
+                end = glyph_start;
+                break;
+            }
+            if (code_point == kSpace) {
+                word_end = glyph_start;
+                word_width = line_width;
+            }
+            used += glyph_width + spacing;
+            line_width = used - spacing;
+            glyph_start = end;
+            // Remember the last position that still leaves room for "..."
+            if (used + ellipsis_width <= width) {
+                ellipsis_end = end;
+                ellipsis_line_width = used;
+            }
+        }
+
+        const bool last_line = line + 1 == pages;
+        const bool overflow = *end != kNull_char && *end != kNew_line;
+        bool truncated = false;
+        if (last_line) {
+            truncated = overflow ||
+                        (*end == kNew_line && *(end + 1) != kNull_char);
+        } else if (overflow && word_end != nullptr) {
+            // Wrap at the last space of the line
+            end = word_end;
+            line_width = word_width;
+        } else if (overflow && end == string) {
+            // A single glyph wider than the box, show as much of it as fits
+            end = glyph_end;
+            line_width = width;
+        }
+
+        if (truncated) {
+            end = ellipsis_end;
+            line_width = ellipsis_line_width + ellipsis_width;
+            if (line_width > width) {
+                line_width = width;
+            }
+            did_not_fit = true;
+        }
+
+        uint8_t offset = 0;
+        if (alignment == nokia_lcd::Alignment::kCenter) {
+            offset = (width - line_width) / 2;
+        } else if (alignment == nokia_lcd::Alignment::kRight) {
+            offset = width - line_width;
+        }
+
+        // Each line is written from edge to edge with one address command
+        setCursor(x, page + line);
+        uint8_t remaining = width - offset;
+        drawBlank(offset);
+        decoder = Utf8Decoder();
+        for (const char *character = string; character != end; character++) {
+            if (mCurrentFont->decode(decoder, *character, code_point)) {
+                printClipped(code_point, remaining);
+            }
+        }
+        if (truncated) {
+            for (const char *dot = kEllipsis; *dot != kNull_char; dot++) {
+                printClipped(*dot, remaining);
+            }
+        }
+        drawBlank(remaining);
+
+        // Continue after the line, without carrying over the spaces and the
+        // new line that separated it from the rest of the text
+        string = end;
+        while (*string == kSpace) {
+            string++;
+        }
+        if (*string == kNew_line) {
+            string++;
+        }
+    }
+    endTransfer();
+
+    return did_not_fit;
+}
+
+void Nokia_LCD::printClipped(const uint16_t code_point, uint8_t &remaining) {
+    unsigned int hidden = 0;
+    printClipped(code_point, hidden, remaining);
+}
+
+void Nokia_LCD::printClipped(const uint16_t code_point, unsigned int &hidden,
+                             uint8_t &remaining) {
+    const LcdGlyph glyph = mCurrentFont->getExtendedGlyph(code_point);
+    const uint8_t first = glyph.width < hidden ? glyph.width : hidden;
+    hidden -= first;
+    uint8_t columns = glyph.width - first;
+    columns = columns < remaining ? columns : remaining;
+    drawGlyph(glyph, columns, first);
+    remaining -= columns;
+
+    uint8_t spacing = mCurrentFont->hSpaceSize;
+    const uint8_t hidden_spacing = spacing < hidden ? spacing : hidden;
+    hidden -= hidden_spacing;
+    spacing -= hidden_spacing;
+    spacing = spacing < remaining ? spacing : remaining;
+    draw(mCurrentFont->hSpace, spacing, false);
+    remaining -= spacing;
+}
+
+void Nokia_LCD::drawBlank(uint8_t count) {
+    beginTransfer();
+    while (count-- > 0) {
+        draw(kBlank_column, sizeof(kBlank_column), false);
+    }
+    endTransfer();
 }
 
 bool Nokia_LCD::draw(const unsigned char bitmap[],
                      const unsigned int bitmap_size,
                      const bool read_from_progmem,
                      const unsigned int bitmap_width) {
+    return drawBytes(bitmap, bitmap_size, read_from_progmem, mX_cursor,
+                     bitmap_width);
+}
+
+bool Nokia_LCD::drawStream(Stream &source, const uint8_t width,
+                           const uint8_t height) {
+    return drawChunks(
+        [&source](unsigned char chunk[], unsigned int size) {
+            return static_cast<unsigned int>(source.readBytes(chunk, size));
+        },
+        width * ((height + kRows_per_page - 1) / kRows_per_page), width);
+}
+
+bool Nokia_LCD::drawStream(ReadBitmapCallback source, const uint8_t width,
+                           const uint8_t height) {
+    return drawChunks(source,
+                      width * ((height + kRows_per_page - 1) / kRows_per_page),
+                      width);
+}
+
+bool Nokia_LCD::drawBytes(const unsigned char bitmap[],
+                          const unsigned int bitmap_size,
+                          const bool read_from_progmem,
+                          const unsigned int x_start_position,
+                          const unsigned int bitmap_width) {
     bool out_of_bounds = false;
-    const unsigned int initialX = mX_cursor;
+    beginTransfer();
     for (unsigned int i = 0; i < bitmap_size; i++) {
-        unsigned char pixel =
-            read_from_progmem ? pgm_read_byte_near(bitmap + i) : bitmap[i];
+        sendBitmapByte(bitmap, i, read_from_progmem);
+        out_of_bounds =
+            updateCursorPosition(x_start_position, bitmap_width) ||
+            out_of_bounds;
+    }
+    endTransfer();
+
+    return out_of_bounds;
+}
+
+bool Nokia_LCD::drawGlyph(const LcdGlyph &glyph, const uint8_t columns,
+                          const uint8_t first) {
+    const uint8_t x_start = mX_cursor;
+    bool out_of_bounds = false;
+    beginTransfer();
+    // Each column is unpacked right before it is sent
+    for (uint8_t i = 0; i < columns; i++) {
+        unsigned char column = glyph.getColumn(first + i);
         if (mInverted) {
-            pixel = ~pixel;
+            column = ~column;
         }
-        sendData(pixel, false);
+        sendData(column, false);
         out_of_bounds =
-            updateCursorPosition(initialX, bitmap_width) || out_of_bounds;
+            updateCursorPosition(x_start, nokia_lcd::kDisplay_max_width) ||
+            out_of_bounds;
+    }
+    endTransfer();
+
+    return out_of_bounds;
+}
+
+bool Nokia_LCD::drawColumns(const unsigned char bitmap[],
+                            const unsigned int bitmap_size,
+                            const uint8_t pages,
+                            const bool read_from_progmem) {
+    // The bytes of a partial column could not be drawn
+    if (pages == 0 || pages > rows() || bitmap_size % pages != 0) {
+        return true;
     }
 
+    const unsigned int width = bitmap_size / pages;
+    const uint8_t x_start = mX_cursor;
+    const uint8_t y_start = mY_cursor;
+    // Vertical addressing needs the cursor to be set before every column but
+    // the first, unless the columns span the whole height, while horizontal
+    // addressing needs it before every row but the first
+    const bool full_height = pages == rows();
+    bool vertical = full_height || width < pages;
+#ifdef NOKIA_LCD_ENABLE_ROTATION
+    // Rotated bytes are always sent with horizontal addressing
+    vertical = vertical && !mRotated;
+#endif
+
+    bool out_of_bounds = false;
+    beginTransfer();
+    setAddressing(vertical);
+    if (vertical) {
+        for (unsigned int i = 0; i < width * pages; i++) {
+            sendBitmapByte(bitmap, i, read_from_progmem);
+            out_of_bounds =
+                updateCursorPosition(0, columns(), y_start,
+                                     y_start + pages) ||
+                out_of_bounds;
+        }
+    } else {
+        for (uint8_t page = 0; page < pages; page++) {
+            for (unsigned int column = 0; column < width; column++) {
+                sendBitmapByte(bitmap, column * pages + page,
+                               read_from_progmem);
+                out_of_bounds =
+                    updateCursorPosition(x_start, width) || out_of_bounds;
+            }
+        }
+    }
+    // Every other drawing path relies on horizontal addressing
+    setAddressing(false);
+    endTransfer();
+
     return out_of_bounds;
 }
 
+void Nokia_LCD::sendBitmapByte(const unsigned char bitmap[],
+                               const unsigned int index,
+                               const bool read_from_progmem) {
+    unsigned char pixel =
+        read_from_progmem ? nokia_lcd::readFlashByte(bitmap + index) : bitmap[index];
+    if (mInverted) {
+        pixel = ~pixel;
+    }
+    sendData(pixel, false);
+}
+
+void Nokia_LCD::setAddressing(const bool vertical) {
+    if (mVertical_addressing == vertical) {
+        return;
+    }
+    mVertical_addressing = vertical;
+    sendCommand(functionSet());
+}
+
 void Nokia_LCD::sendCommand(const unsigned char command) {
     send(command, false);
 }
 
+void Nokia_LCD::sendCommands(const unsigned char commands[],
+                             const uint8_t count) {
+    beginTransfer();
+    for (uint8_t i = 0; i < count; i++) {
+        send(commands[i], false);
+    }
+    endTransfer();
+}
+
 bool Nokia_LCD::sendData(const unsigned char data) {
     return sendData(data, true);
 }
@@ -269,149 +1108,524 @@ bool Nokia_LCD::sendData(const unsigned char data, const bool update_cursor) {
 }
 
 bool Nokia_LCD::updateCursorPosition(const unsigned int x_start_position,
-                                     const unsigned int x_end_position) {
+                                     const unsigned int x_end_position,
+                                     const uint8_t y_start_position,
+                                     const uint8_t y_end_position) {
     bool out_of_bounds = false;
-
-    mX_cursor =
-        (mX_cursor + 1) %
-        (x_start_position +
-         x_end_position);  // Used to determine if X reached the right margin.
-                           // E.g. starts drawing on column 10, an image of 25px
-                           // width, X will reach the right margin at 35px, so
-                           // we have to break line
-    // Calculate the cursor position after the byte being sent
-    if (mX_cursor == 0) {
-        mX_cursor = x_start_position;  // return X to the initial position
-        // If the column just became 0, this means the row should change
-        mY_cursor = (mY_cursor + 1) % kTotal_rows;  // Row
-        if (mY_cursor == 0) {
-            // If we are back to row 0 again, then we just went out of bounds
-            out_of_bounds = true;
+    // Where the display's own address counter points after the byte just sent
+    uint8_t next_x, next_y;
+    if (mVertical_addressing) {
+        const bool wraps = mY_cursor + 1U >= rows();
+        next_y = !wraps ? mY_cursor + 1
+                        : (kPanel_fills_ram ? 0 : kUnknown_address);
+        next_x = !wraps ? mX_cursor
+                        : (mX_cursor + 1U < columns() ? mX_cursor + 1 : 0);
+
+        // Go down the rows and then on to the top of the next column
+        mY_cursor++;
+        if (mY_cursor >= y_end_position) {
+            mY_cursor = y_start_position;
+            mX_cursor++;
+            if (mX_cursor >= columns()) {
+                // If we are back to column 0, then we just went out of bounds
+                mX_cursor = 0;
+                out_of_bounds = true;
+            }
+        }
+    } else {
+        const bool wraps = mX_cursor + 1U >= columns();
+        next_x = !wraps ? mX_cursor + 1
+                        : (kPanel_fills_ram ? 0 : kUnknown_address);
+        next_y = !wraps ? mY_cursor
+                        : (mY_cursor + 1U < rows() ? mY_cursor + 1 : 0);
+
+        // Calculate the cursor position after the byte being sent
+        mX_cursor++;
+        // Used to determine if X reached the right margin. E.g. starts
+        // drawing on column 10, an image of 25px width, X will reach the right
+        // margin at 35px, so we have to break line and return X to the
+        // initial position. Whatever does not fit on the screen, such as
+        // text, continues at the beginning of the next row instead.
+        const bool reached_margin =
+            mX_cursor >= x_start_position + x_end_position;
+        if (reached_margin || mX_cursor >= columns()) {
+            mX_cursor = reached_margin ? x_start_position : 0;
+            mY_cursor = mY_cursor + 1U < rows() ? mY_cursor + 1 : 0;  // Row
+            if (mY_cursor == 0) {
+                // If we are back to row 0 again, then we just went out of
+                // bounds
+                out_of_bounds = true;
+            }
         }
     }
 
-    setCursor(mX_cursor, mY_cursor);  // updates the cursor position
+    // Only address the display when its auto-increment does not already
+    // land on the new cursor position
+    if (mX_cursor != next_x || mY_cursor != next_y) {
+        setCursor(mX_cursor, mY_cursor);
+    }
     return out_of_bounds;
 }
 
 bool Nokia_LCD::send(const unsigned char lcd_byte, const bool is_data,
                      const bool update_cursor) {
+#ifdef NOKIA_LCD_ENABLE_ROTATION
+    if (is_data && mRotated) {
+        beginTransfer();
+        stash(lcd_byte);
+        endTransfer();
+    } else if (is_data) {
+        // Not rotated, the cursor is where the display writes the byte to
+        transmitTo(lcd_byte, mX_cursor, mY_cursor);
+    } else {
+        transmit(lcd_byte, is_data);
+    }
+#else
+    transmit(lcd_byte, is_data);
+#endif
+
+    // If we just sent the command, there was no out-of-bounds error
+    // and we don't have to calculate the new cursor position
+    if (!is_data || !update_cursor) {
+        return false;
+    }
+
+    return updateCursorPosition();
+}
+
+void Nokia_LCD::transmit(const unsigned char lcd_byte, const bool is_data) {
+#ifdef NOKIA_LCD_ENABLE_STATS
+    const unsigned long start = micros();
+    if (is_data) {
+        mStats.data_bytes++;
+    } else {
+        mStats.commands++;
+    }
+#endif
+    // Outside a burst this selects the display just for this byte
+    beginTransfer();
     // Tell the LCD that we are writing either to data or a command
-    digitalWrite(kDc_pin, is_data);
+    setDataMode(is_data);
+
+    NOKIA_LCD_RECORD(is_data ? nokia_lcd::kTrace_data : 0, lcd_byte);
 
     // Send the byte
-    if (!mCoupled) {
-        digitalWrite(kCe_pin, LOW);
-    }
     if (kUsingHardwareSPI) {
-        constexpr uint32_t kSPiClockSpeed{F_CPU / 4U};
-        SPI.beginTransaction(SPISettings{kSPiClockSpeed, MSBFIRST, SPI_MODE0});
         SPI.transfer(lcd_byte);
-        SPI.endTransaction();
     } else {
         shiftOut(kDin_pin, kClk_pin, MSBFIRST, lcd_byte);
     }
+    endTransfer();
+#ifdef NOKIA_LCD_ENABLE_STATS
+    mStats.send_micros += micros() - start;
+#endif
+}
 
-    if (!mCoupled) {
-        digitalWrite(kCe_pin, HIGH);
+#ifdef NOKIA_LCD_ENABLE_ROTATION
+void Nokia_LCD::setRotation(nokia_lcd::Rotation rotation, bool mirrored) {
+    beginTransfer();
+    flushTile();
+    mTile_x = kNo_tile;
+    mRotation = rotation;
+    mMirrored = mirrored;
+    mPortrait = rotation == nokia_lcd::Rotation::k90 ||
+                rotation == nokia_lcd::Rotation::k270;
+    mRotated = rotation != nokia_lcd::Rotation::k0 || mirrored;
+    // Rotated bytes are sent in runs from left to right
+    if (mRotated) {
+        setAddressing(false);
     }
+    setCursor(0, 0);
+    endTransfer();
+}
 
-    // If we just sent the command, there was no out-of-bounds error
-    // and we don't have to calculate the new cursor position
-    if (!is_data || !update_cursor) {
-        return false;
+uint8_t Nokia_LCD::getWidth() { return columns(); }
+
+uint8_t Nokia_LCD::getHeight() { return rows() * kRows_per_page; }
+
+void Nokia_LCD::stash(const unsigned char data) {
+    const uint8_t tile_x = mX_cursor & ~(kTile_size - 1);
+    if (tile_x != mTile_x || mY_cursor != mTile_y) {
+        flushTile();
+        memset(mTile, 0, sizeof(mTile));
+        mTile_x = tile_x;
+        mTile_y = mY_cursor;
+        mTile_used = 0;
     }
+    const uint8_t column = mX_cursor - tile_x;
+    mTile[column] = data;
+    mTile_used |= 1 << column;
+    mTile_dirty = true;
+}
 
-    return updateCursorPosition();
+void Nokia_LCD::flushTile() {
+    if (!mTile_dirty) {
+        return;
+    }
+    mTile_dirty = false;
+
+    const uint8_t last_row = kTotal_rows - 1;
+    const uint8_t last_column = kTotal_columns - 1;
+    if (!mPortrait) {
+        // Upside down, the columns are sent in reverse order and the bits of
+        // each column are reversed. Each run of columns drawn on is addressed.
+        const bool upside_down = mRotation == nokia_lcd::Rotation::k180;
+        const bool reversed = mMirrored != upside_down;
+        const uint8_t page = upside_down ? last_row - mTile_y : mTile_y;
+        bool addressed = false;
+        for (uint8_t i = 0; i < kTile_size; i++) {
+            const uint8_t column = reversed ? kTile_size - 1 - i : i;
+            if (!(mTile_used & (1 << column))) {
+                addressed = false;
+                continue;
+            }
+            const uint8_t x =
+                reversed ? last_column - mTile_x - column : mTile_x + column;
+            if (!addressed) {
+                addressDisplay(x, page);
+                addressed = true;
+            }
+            transmitTo(upside_down ? reverseBits(mTile[column]) : mTile[column],
+                       x, page);
+        }
+        return;
+    }
+
+    // On its side, the 8 columns of the tile become 8 rows of pixels of a
+    // single row of the display, so the whole tile is sent at once. The
+    // columns that were not drawn on keep what the display already shows.
+    unsigned char used[kTile_size];
+    for (uint8_t column = 0; column < kTile_size; column++) {
+        used[column] = (mTile_used & (1 << column)) ? 0xFF : 0x00;
+    }
+    unsigned char transposed[kTile_size];
+    unsigned char transposed_used[kTile_size];
+    transpose(mTile, transposed);
+    transpose(used, transposed_used);
+    const bool clockwise = mRotation == nokia_lcd::Rotation::k90;
+    const bool reversed = clockwise == mMirrored;
+    const uint8_t page =
+        (reversed ? nokia_lcd::kDisplay_max_height - kTile_size - mTile_x
+                  : mTile_x) /
+        kRows_per_page;
+    const uint8_t first_row = mTile_y * kRows_per_page;
+    const uint8_t first_x =
+        clockwise ? last_column - first_row - (kRows_per_page - 1) : first_row;
+    addressDisplay(first_x, page);
+    for (uint8_t i = 0; i < kTile_size; i++) {
+        const uint8_t row = clockwise ? kTile_size - 1 - i : i;
+        unsigned char column = transposed[row];
+        unsigned char mask = transposed_used[row];
+        if (reversed) {
+            column = reverseBits(column);
+            mask = reverseBits(mask);
+        }
+        const uint8_t x = first_x + i;
+        transmitTo((column & mask) | (mDisplay_ram[page][x] & ~mask), x, page);
+    }
 }
 
-bool Nokia_LCD::print(int number) {
-    // Handle the negative numbers
-    if (number < 0) {
-        print("-");
-        // We took care of the sign, so now we can treat the number as unsigned
-        number = -number;
+void Nokia_LCD::transmitTo(const unsigned char data, const uint8_t x,
+                           const uint8_t page) {
+    mDisplay_ram[page][x] = data;
+    transmit(data, true);
+}
+#endif
+
+bool Nokia_LCD::print(unsigned char number, int base) {
+    return print(static_cast<unsigned long>(number), base);
+}
+
+bool Nokia_LCD::print(int number, int base) {
+    return print(static_cast<long>(number), base);
+}
+
+bool Nokia_LCD::print(unsigned int number, int base) {
+    return print(static_cast<unsigned long>(number), base);
+}
+
+bool Nokia_LCD::print(long number, int base) {
+    // Handle the negative numbers, which like with Print only have a sign
+    // when printed in decimal
+    if (number < 0 && base == DEC) {
+        beginTransfer();
+        bool out_of_bounds = print('-');
+        // We took care of the sign, so now we can treat the number as
+        // unsigned. Negating it as unsigned also works for the smallest long.
+        out_of_bounds =
+            print(0UL - static_cast<unsigned long>(number)) || out_of_bounds;
+        endTransfer();
+
+        return out_of_bounds;
     }
-    return print(static_cast<unsigned long>(number));
+    return print(static_cast<unsigned long>(number), base);
 }
 
-bool Nokia_LCD::print(unsigned int number) {
-    return print(static_cast<unsigned long>(number));
+bool Nokia_LCD::print(unsigned long number, int base) {
+    if (base == 0) {
+        return print(static_cast<char>(number));
+    }
+    if (base < 2 || base > kMax_base) {
+        base = DEC;
+    }
+
+    return printDigits(number, 1, base, true);
 }
 
-bool Nokia_LCD::print(long number) {
-    // Handle the negative numbers
+bool Nokia_LCD::print(double number, int decimals) {
+    if (decimals < 0) {
+        decimals = 0;
+    } else if (decimals > kMax_decimals) {
+        decimals = kMax_decimals;
+    }
+    const char *unprintable = unprintableFloat(number);
+    if (unprintable != nullptr) {
+        return print(unprintable);
+    }
+    bool out_of_bounds = false;
+    beginTransfer();
+    // The sign is printed separately, since the integral part of numbers
+    // between -1 and 0 has none
     if (number < 0) {
-        print("-");
-        // We took care of the sign, so now we can treat the number as unsigned
+        out_of_bounds = print('-');
         number = -number;
     }
-    return print(static_cast<unsigned long>(number));
+
+    unsigned long integral;
+    unsigned long fractional;
+    splitDecimals(number, decimals, integral, fractional);
+
+    // prints the left hand side of the dot
+    out_of_bounds = printDigits(integral) || out_of_bounds;
+
+    if (decimals > 0) {
+        // prints the fractional part, including any leading 0s after the dot
+        out_of_bounds = print('.') || out_of_bounds;
+        out_of_bounds = printDigits(fractional, decimals) || out_of_bounds;
+    }
+    endTransfer();
+
+    return out_of_bounds;
 }
 
-bool Nokia_LCD::print(unsigned long number) {
-    // The log base 10 of the number increased by 1 indicates how many digits
-    // there are in a number.
-    const uint8_t length_as_string =
-        static_cast<uint8_t>(log10(number)) + 1 + sizeof(kNull_char);
-    char number_as_string[kMax_number_length] = {0};
-    snprintf(number_as_string, length_as_string, "%lu", number);
+bool Nokia_LCD::printDigits(unsigned long number, const uint8_t min_digits,
+                            const uint8_t base, const bool uppercase) {
+    // Find the most significant digit to be printed. The divisor can only
+    // grow past the number to pad it with zeros, so that is where it may
+    // overflow.
+    const unsigned long max_divisor = ~0UL / base;
+    unsigned long divisor = 1;
+    uint8_t digits = 1;
+    while (divisor <= max_divisor &&
+           (digits < min_digits || number / divisor >= base)) {
+        divisor *= base;
+        digits++;
+    }
 
-    return print(number_as_string);
+    const char letters = uppercase ? 'A' : 'a';
+    bool out_of_bounds = false;
+    beginTransfer();
+    for (; divisor > 0; divisor /= base) {
+        const uint8_t digit = number / divisor;
+        number -= digit * divisor;
+        const char character = digit < 10 ? '0' + digit : letters + digit - 10;
+        out_of_bounds = printCharacter(character) || out_of_bounds;
+    }
+    endTransfer();
+
+    return out_of_bounds;
+}
+
+bool Nokia_LCD::printf(const char *format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    const bool out_of_bounds = printFormatted(format, false, arguments);
+    va_end(arguments);
+
+    return out_of_bounds;
+}
+
+bool Nokia_LCD::printf(const __FlashStringHelper *format, ...) {
+    va_list arguments;
+    va_start(arguments, format);
+    const bool out_of_bounds = printFormatted(
+        reinterpret_cast<const char *>(format), true, arguments);
+    va_end(arguments);
+
+    return out_of_bounds;
 }
 
-bool Nokia_LCD::print(double number, unsigned short decimals) {
-    double integral = 0;
-    long fractional = pow(10.0, decimals) * modf(number, &integral);
+bool Nokia_LCD::printFormatted(const char *format,
+                               const bool read_from_progmem,
+                               va_list arguments) {
     bool out_of_bounds = false;
+    beginTransfer();
+    while (true) {
+        char character = readFormat(format, read_from_progmem);
+        if (character == kNull_char) {
+            break;
+        }
+        if (character != kFormat_escape) {
+            out_of_bounds = printCharacter(character) || out_of_bounds;
+            continue;
+        }
 
-    // prints the left hand side of the dot
-    out_of_bounds = out_of_bounds || print(static_cast<long>(number));
-    out_of_bounds = out_of_bounds || print(".");
-
-    // prints any leading 0s after the dot
-    for (int d = decimals - 1; (0 <= d); d--) {
-        int num = fractional / pow(10, d);
-        if (num == 0) {
-            out_of_bounds = out_of_bounds || print(num);
+        // The flags, the width, the decimals and the length, e.g. "%-05.1lf"
+        bool align_left = false;
+        bool pad_with_zeros = false;
+        unsigned int width = 0;
+        uint8_t decimals = kDefault_decimals;
+        bool is_long = false;
+        character = readFormat(format, read_from_progmem);
+        while (character == '-' || character == '0') {
+            align_left = align_left || character == '-';
+            pad_with_zeros = pad_with_zeros || character == '0';
+            character = readFormat(format, read_from_progmem);
+        }
+        while (character >= '0' && character <= '9') {
+            width = width * 10 + character - '0';
+            character = readFormat(format, read_from_progmem);
+        }
+        if (character == '.') {
+            decimals = 0;
+            character = readFormat(format, read_from_progmem);
+            while (character >= '0' && character <= '9') {
+                decimals = decimals * 10 + character - '0';
+                decimals = decimals < kMax_decimals ? decimals : kMax_decimals;
+                character = readFormat(format, read_from_progmem);
+            }
+        }
+        if (character == 'l') {
+            is_long = true;
+            character = readFormat(format, read_from_progmem);
+        }
+
+        // Everything but the padding is known before it is printed, so that
+        // the padding can go first
+        bool is_negative = false;
+        unsigned long number = 0;
+        unsigned long fractional = 0;
+        uint8_t base = 10;
+        char letter[] = {character, kNull_char};
+        const char *text = nullptr;
+        unsigned int length = 0;
+        if (character == 'd') {
+            const long value =
+                is_long ? va_arg(arguments, long) : va_arg(arguments, int);
+            is_negative = value < 0;
+            // Negated as unsigned, since the lowest long has no positive
+            number = is_negative ? 0UL - value : value;
+        } else if (character == 'u' || character == 'x') {
+            number = is_long ? va_arg(arguments, unsigned long)
+                             : va_arg(arguments, unsigned int);
+            base = character == 'x' ? 16 : 10;
+        } else if (character == 'f') {
+            double value = va_arg(arguments, double);
+            text = unprintableFloat(value);
+            is_negative = text == nullptr && value < 0;
+            value = is_negative ? -value : value;
+            if (text == nullptr) {
+                splitDecimals(value, decimals, number, fractional);
+            } else {
+                decimals = 0;
+            }
+        } else if (character == 'c') {
+            letter[0] = static_cast<char>(va_arg(arguments, int));
+            text = letter;
+        } else if (character == 's') {
+            text = va_arg(arguments, const char *);
+            text = text != nullptr ? text : "";
+        } else if (character == kNull_char) {
+            // A lone '%' at the end of the format
+            break;
+        } else {
+            // "%%" and unknown conversions print their letter
+            text = letter;
+        }
+
+        if (text != nullptr) {
+            // A character of UTF-8 takes up a single glyph
+            for (const char *byte = text; *byte != kNull_char; byte++) {
+                length += !nokia_lcd::detail::isContinuation(*byte);
+            }
+            pad_with_zeros = false;
         } else {
-            break;  // no more 0s to print so break
+            length = is_negative + countDigits(number, base);
+            if (character == 'f' && decimals > 0) {
+                length += 1 + decimals;
+            }
+        }
+        const unsigned int padding = width > length ? width - length : 0;
+
+        if (!align_left && !pad_with_zeros) {
+            out_of_bounds = printRepeated(kSpace, padding) || out_of_bounds;
+        }
+        if (is_negative) {
+            out_of_bounds = printCharacter('-') || out_of_bounds;
+        }
+        if (!align_left && pad_with_zeros) {
+            out_of_bounds = printRepeated('0', padding) || out_of_bounds;
+        }
+        if (text != nullptr) {
+            out_of_bounds = print(text) || out_of_bounds;
+        } else {
+            out_of_bounds = printDigits(number, 1, base) || out_of_bounds;
+        }
+        if (character == 'f' && decimals > 0) {
+            out_of_bounds = printCharacter('.') || out_of_bounds;
+            out_of_bounds = printDigits(fractional, decimals) || out_of_bounds;
+        }
+        if (align_left) {
+            out_of_bounds = printRepeated(kSpace, padding) || out_of_bounds;
         }
     }
+    endTransfer();
 
-    if (fractional == 0) {
-        // If the fractional part is 0, then we have already printed it
-        return out_of_bounds;
+    return out_of_bounds;
+}
+
+bool Nokia_LCD::printRepeated(const char character, unsigned int count) {
+    bool out_of_bounds = false;
+    beginTransfer();
+    while (count-- > 0) {
+        out_of_bounds = printCharacter(character) || out_of_bounds;
     }
-    // prints the rest of the fractional
-    return (out_of_bounds || print(fractional));
+    endTransfer();
+
+    return out_of_bounds;
+}
+
+bool Nokia_LCD::println(unsigned char number, int base) {
+    bool out_of_bounds = print(number, base);
+
+    return print("\n") || out_of_bounds;
 }
 
-bool Nokia_LCD::println(int number) {
-    bool out_of_bounds = print(number);
+bool Nokia_LCD::println(int number, int base) {
+    bool out_of_bounds = print(number, base);
 
     return print("\n") || out_of_bounds;
 }
 
-bool Nokia_LCD::println(unsigned int number) {
-    bool out_of_bounds = print(number);
+bool Nokia_LCD::println(unsigned int number, int base) {
+    bool out_of_bounds = print(number, base);
 
     return print("\n") || out_of_bounds;
 }
 
-bool Nokia_LCD::println(long number) {
-    bool out_of_bounds = print(number);
+bool Nokia_LCD::println(long number, int base) {
+    bool out_of_bounds = print(number, base);
 
     return print("\n") || out_of_bounds;
 }
 
-bool Nokia_LCD::println(unsigned long number) {
-    bool out_of_bounds = print(number);
+bool Nokia_LCD::println(unsigned long number, int base) {
+    bool out_of_bounds = print(number, base);
 
     return print("\n") || out_of_bounds;
 }
 
-bool Nokia_LCD::println(double number, unsigned short decimals) {
+bool Nokia_LCD::println(double number, int decimals) {
     bool out_of_bounds = print(number, decimals);
 
     return print("\n") || out_of_bounds;
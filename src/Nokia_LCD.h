@@ -11,17 +11,173 @@
  */
 #pragma once
 #include <Arduino.h>
+#include <stdarg.h>
 #include <stdint.h>
 
 #include "LCD_Fonts.h"
 
+// To find out where the time of a screen update goes, insert
+// `#define NOKIA_LCD_ENABLE_STATS` in this file. The library then counts what
+// it sends to the display, see `Nokia_LCD::getStats()`. When it is not
+// defined, the counters take neither memory nor time.
+//
+// To record everything that is sent to the display, e.g. to compare the output
+// of two versions of a sketch with `extras/nokia_lcd_trace.py`, insert
+// `#define NOKIA_LCD_ENABLE_TRACE` in this file. The last
+// `NOKIA_LCD_TRACE_CAPACITY` bytes and chip select changes are kept, see
+// `Nokia_LCD::exportTrace()`.
+#if defined(NOKIA_LCD_ENABLE_TRACE) && !defined(NOKIA_LCD_TRACE_CAPACITY)
+#define NOKIA_LCD_TRACE_CAPACITY 128
+#endif
+//
+// To mount the display upside down or in portrait, insert
+// `#define NOKIA_LCD_ENABLE_ROTATION` in this file, see
+// `Nokia_LCD::setRotation()`. It keeps a copy of the display's memory, 504
+// bytes for the default panel.
+//
+// To drive a PCD8544 compatible controller with a panel of another size,
+// insert `#define NOKIA_LCD_WIDTH` with its width in pixels and
+// `#define NOKIA_LCD_PAGES` with its height in rows of 8 pixels in this file.
+// If the panel is not connected to the first column of the controller,
+// `#define NOKIA_LCD_COLUMN_OFFSET` with the first column it is connected to.
+// The geometry is fixed at compile time, so all the cursor math is done with
+// constants.
+#ifndef NOKIA_LCD_WIDTH
+#define NOKIA_LCD_WIDTH 84
+#endif
+#ifndef NOKIA_LCD_PAGES
+#define NOKIA_LCD_PAGES 6
+#endif
+#ifndef NOKIA_LCD_COLUMN_OFFSET
+#define NOKIA_LCD_COLUMN_OFFSET 0
+#endif
+static_assert(NOKIA_LCD_WIDTH > 0 &&
+                  NOKIA_LCD_WIDTH + NOKIA_LCD_COLUMN_OFFSET <= 128,
+              "Columns are addressed with 7 bits");
+static_assert(NOKIA_LCD_PAGES > 0 && NOKIA_LCD_PAGES <= 8,
+              "Rows are addressed with 3 bits");
+
 namespace nokia_lcd {
 // Display constants
-const uint8_t kDisplay_max_width = 84;
-const uint8_t kDisplay_max_height = 48;
+constexpr uint8_t kDisplay_max_width = NOKIA_LCD_WIDTH;
+constexpr uint8_t kDisplay_max_rows = NOKIA_LCD_PAGES;  // 8 pixels each
+constexpr uint8_t kDisplay_max_height = kDisplay_max_rows * 8;
+constexpr uint8_t kDisplay_column_offset = NOKIA_LCD_COLUMN_OFFSET;
+
+// Metrics of the default font
+const uint8_t kDefault_glyph_width = 5;
+const uint8_t kDefault_glyph_spacing = 1;
+
+// Horizontal text alignment
+enum class Alignment : uint8_t { kLeft, kCenter, kRight };
+
+// The settings a display is initialized with
+struct InitProfile {
+    uint8_t contrast;                 // Operating voltage (Vop), 0 to 127
+    uint8_t bias;                     // Bias system, 0 to 7
+    uint8_t temperature_coefficient;  // 0 to 3
+};
+
+// Good for most displays
+const InitProfile kDefault_init_profile{0x30, 0x04, 0x00};
+
+// How many bytes are buffered at a time when drawing from a stream
+const uint8_t kStream_chunk_size = 16;
+
+#ifdef NOKIA_LCD_ENABLE_STATS
+// What has been sent to the display since the counters were last reset
+struct Stats {
+    uint32_t commands;            // Command bytes
+    uint32_t data_bytes;          // Data bytes
+    uint32_t transfers;           // Outermost `beginTransfer()` calls
+    uint32_t ce_toggles;          // Chip select (CE) pin changes
+    uint32_t dc_toggles;          // Data/command (DC) pin writes
+    uint32_t cursor_addressings;  // Times the cursor was set on the display
+    uint32_t glyphs;              // Characters drawn
+    uint32_t send_micros;         // Time spent sending bytes
+};
+#endif
+
+#ifdef NOKIA_LCD_ENABLE_TRACE
+// A recorded byte or chip select (CE) change
+struct TraceEntry {
+    uint8_t flags;  // `kTrace_data` and `kTrace_ce`
+    uint8_t value;  // The byte or, for CE changes, the new pin level
+};
+const uint8_t kTrace_data = 0x01;  // Sent as data instead of a command
+const uint8_t kTrace_ce = 0x02;    // A CE change instead of a byte
+const uint16_t kTrace_capacity = NOKIA_LCD_TRACE_CAPACITY;
+#endif
+
+#ifdef NOKIA_LCD_ENABLE_ROTATION
+// Clockwise rotation of what is shown
+enum class Rotation : uint8_t { k0, k90, k180, k270 };
+#endif
+
+// The space a text occupies on the screen
+struct TextSize {
+    uint16_t width;  // Width of the widest line in pixels
+    uint8_t lines;   // A trailing new line does not start another line
+};
+
+namespace detail {
+constexpr uint16_t lineWidth(uint16_t characters, uint8_t glyph_width,
+                             uint8_t spacing) {
+    return characters == 0 ? 0 : characters * (glyph_width + spacing) - spacing;
+}
+
+constexpr uint16_t widest(uint16_t a, uint16_t b) { return a > b ? a : b; }
+
+// The bytes of UTF-8 after the first one of a character
+constexpr bool isContinuation(char byte) {
+    return (static_cast<unsigned char>(byte) & 0xC0) == 0x80;
+}
+
+constexpr TextSize measureText(const char *string, uint8_t glyph_width,
+                               uint8_t spacing, uint16_t characters,
+                               uint16_t width, uint8_t lines) {
+    return *string == '\0'
+               ? TextSize{widest(width,
+                                 lineWidth(characters, glyph_width, spacing)),
+                          static_cast<uint8_t>(lines + (characters > 0))}
+           : *string == '\n'
+               ? measureText(string + 1, glyph_width, spacing, 0,
+                             widest(width, lineWidth(characters, glyph_width,
+                                                     spacing)),
+                             lines + 1)
+               : measureText(string + 1, glyph_width, spacing,
+                             characters + !isContinuation(*string), width,
+                             lines);
+}
+}  // namespace detail
+
+/**
+ * Measures the supplied text without drawing it, for fonts whose glyphs all
+ * have the same width. A character of UTF-8 counts as a single glyph, no
+ * matter how many bytes it takes. Can be evaluated at compile time, e.g.
+ * `constexpr auto size = nokia_lcd::measureText("Menu");`
+ * @param  string      The text to be measured
+ * @param  glyph_width The width of every glyph (`LcdFont::columnSize`)
+ * @param  spacing     The spacing after every glyph (`LcdFont::hSpaceSize`)
+ * @return             The width of the widest line and the number of lines
+ */
+constexpr TextSize measureText(const char *string,
+                               uint8_t glyph_width = kDefault_glyph_width,
+                               uint8_t spacing = kDefault_glyph_spacing) {
+    return detail::measureText(string, glyph_width, spacing, 0, 0, 0);
+}
+
+/**
+ * Measures the supplied text as it would be printed with the specified font,
+ * without drawing it. Only the font metrics are used.
+ * @param  string The text to be measured
+ * @param  font   The font the text would be printed with
+ * @return        The width of the widest line and the number of lines
+ */
+TextSize measureText(const char *string, const LcdFont *font);
 }  // namespace nokia_lcd
 
-class Nokia_LCD {
+class Nokia_LCD : public Print {
 public:
     /**
      * Nokia_LCD constructor where the pins connected to the display are
@@ -73,17 +229,53 @@ public:
               const uint8_t bl_pin);
 
     /**
-     * Initializes the LCD screen, has to be called before usage or waking up
-     * from deep sleep.
+     * Initializes the LCD screen, has to be called before usage or after the
+     * display has lost power. To wake up a display that was put to sleep with
+     * `sleep()`, use `wake()` instead.
      */
     void begin();
 
+    /**
+     * Initializes the LCD screen with settings that suit a particular display
+     * better than `nokia_lcd::kDefault_init_profile`.
+     * @param profile The settings to initialize the display with
+     */
+    void begin(const nokia_lcd::InitProfile &profile);
+
+    /**
+     * Puts the display in power-down mode, where it draws almost no current.
+     * The screen goes blank but its contents are kept, so they show up again
+     * after `wake()`. Data may still be sent while asleep.
+     */
+    void sleep();
+
+    /**
+     * Wakes the display up from power-down mode and restores the contrast,
+     * bias, temperature coefficient and display mode without resetting it,
+     * so the screen shows what it did before `sleep()`.
+     */
+    void wake();
+
     /**
      * Sets the contrast on the LCD screen
      * @param contrast Contrast value between 40 and 60 is usually good
      */
     void setContrast(uint8_t contrast);
 
+    /**
+     * Sets the bias system of the LCD screen, which has to match its
+     * multiplex rate.
+     * @param bias Bias value between 0 and 7, 4 (1:48) is usually good
+     */
+    void setBias(uint8_t bias);
+
+    /**
+     * Sets how the operating voltage of the LCD screen is compensated for
+     * temperature.
+     * @param coefficient Temperature coefficient between 0 and 3
+     */
+    void setTemperatureCoefficient(uint8_t coefficient);
+
     /**
      * Sets the display "cursor" at the specified position so we can draw from
      * that point. If an invalid cursor position is supplied, an out-of-bounds
@@ -116,26 +308,40 @@ public:
     /**
      * Prints the supplied element starting at the current cursor location. The
      * text will overflow by starting from the beginning if it exceeds the size
-     * of the display.
+     * of the display. Text is decoded from UTF-8, even when it is written one
+     * byte at a time, and code points missing from the font are shown with
+     * its fallback glyph. Fonts without UTF-8 support (`LcdFont::isUtf8()`)
+     * get every byte as it is instead.
      * @param  string The string to be printed on the display
      * @return        True if out of bounds error | False otherwise
      */
     bool print(const char *string);
     bool print(char character);
-    bool print(int number);
-    bool print(unsigned int number);
-    bool print(long number);
-    bool print(unsigned long number);
+
+    /**
+     * Prints a number starting at the current cursor location, in the same
+     * bases as `Print` does, e.g. `lcd.print(255, HEX)` prints "FF". Only
+     * decimal numbers get a sign, others are printed as unsigned.
+     * @param  number The number to be printed on the display
+     * @param  base   `DEC`, `HEX`, `OCT`, `BIN` or any base up to 36, 0 to
+     *                print the number as a character
+     * @return        True if out of bounds error | False otherwise
+     */
+    bool print(unsigned char number, int base = DEC);
+    bool print(int number, int base = DEC);
+    bool print(unsigned int number, int base = DEC);
+    bool print(long number, int base = DEC);
+    bool print(unsigned long number, int base = DEC);
 
     /**
      * Prints the supplied element starting at the current cursor location and
      * goes to the next line. The text will overflow by starting from the
      * beginning if it exceeds the size of the display.
-     * @param  number The string to be printed on the display
-     * @param  digits How many floating point digits to print
-     * @return        True if out of bounds error | False otherwise
+     * @param  number   The string to be printed on the display
+     * @param  decimals How many floating point digits to print, up to 9
+     * @return          True if out of bounds error | False otherwise
      */
-    bool print(double number, unsigned short decimals = 2);
+    bool print(double number, int decimals = 2);
 
     /**
      * Prints the supplied element starting at the current cursor location and
@@ -146,20 +352,37 @@ public:
      */
     bool println(const char *string);
     bool println(char character);
-    bool println(int number);
-    bool println(unsigned int number);
-    bool println(long number);
-    bool println(unsigned long number);
+
+    /**
+     * Prints the supplied string on the current row, so that it is aligned to
+     * the anchor: left aligned text starts at the anchor, right aligned text
+     * ends right before it and centered text is centered around it. Every line
+     * of the string is aligned on its own and cut at the edges of the screen,
+     * including what would be left of it.
+     * @param  string    The string to be printed on the display
+     * @param  anchor_x  The x coordinate the text is aligned to
+     * @param  alignment How the text is placed relative to the anchor
+     * @return           True if out of bounds error | False otherwise
+     */
+    bool print(const char *string, uint8_t anchor_x,
+               nokia_lcd::Alignment alignment);
+    bool println(const char *string, uint8_t anchor_x,
+                 nokia_lcd::Alignment alignment);
+    bool println(unsigned char number, int base = DEC);
+    bool println(int number, int base = DEC);
+    bool println(unsigned int number, int base = DEC);
+    bool println(long number, int base = DEC);
+    bool println(unsigned long number, int base = DEC);
 
     /**
      * Prints the supplied element starting at the current cursor location and
      * goes to the next line. The text will overflow by starting from the
      * beginning if it exceeds the size of the display.
-     * @param  number The string to be printed on the display
-     * @param  digits How many floating point digits to print
-     * @return        True if out of bounds error | False otherwise
+     * @param  number   The string to be printed on the display
+     * @param  decimals How many floating point digits to print, up to 9
+     * @return          True if out of bounds error | False otherwise
      */
-    bool println(double number, unsigned short decimals = 2);
+    bool println(double number, int decimals = 2);
 
 // To increase compatibility with different ATTiny cores, only the classic
 // C-style strings are used by default. If you want to use the Arduino `String`
@@ -169,6 +392,86 @@ public:
     bool println(const String &string);
 #endif
 
+    /**
+     * Prints a string stored in flash memory, e.g. `lcd.print(F("Hello"))`.
+     * The characters are read from flash one by one, never copied to RAM.
+     * @param  string The string to be printed on the display
+     * @return        True if out of bounds error | False otherwise
+     */
+    bool print(const __FlashStringHelper *string);
+    bool println(const __FlashStringHelper *string);
+
+    /**
+     * Prints an object that knows how to print itself via the `Printable`
+     * interface.
+     * @param  printable The object to be printed on the display
+     * @return           The number of characters printed
+     */
+    size_t print(const Printable &printable);
+    size_t println(const Printable &printable);
+    // The overloads of `Print` that are not replaced above, e.g. for `String`
+    // when the display does not print it itself, stay available
+    using Print::print;
+    using Print::println;
+
+    /**
+     * Prints formatted text, e.g. `lcd.printf("T:%3d.%d C", whole, tenths)`.
+     * Each character goes straight to the display, without formatting the
+     * text into a buffer first. Supports `%d`, `%u`, `%x` (with `l` for
+     * longs), `%f` (with `.N` decimals, 2 by default), `%s`, `%c` and `%%`,
+     * each with a minimum width and the flags `-` (align left) and `0` (pad
+     * numbers with zeros).
+     * @param  format The format, which may also be stored in flash memory,
+     *                e.g. `lcd.printf(F("%02d:%02d"), hours, minutes)`
+     * @return        True if out of bounds error | False otherwise
+     */
+    bool printf(const char *format, ...)
+        __attribute__((format(printf, 2, 3)));
+    bool printf(const __FlashStringHelper *format, ...);
+
+    /**
+     * Goes to the beginning of the next line.
+     * @return True if out of bounds error | False otherwise
+     */
+    bool println();
+
+    /**
+     * Prints a single character. Allows the display to be used wherever the
+     * Arduino `Print` interface is expected.
+     * @param  character The character to be printed on the display
+     * @return           The number of characters printed
+     */
+    size_t write(uint8_t character) override;
+
+    /**
+     * Prints a buffer of characters, keeping the bus transaction open until
+     * the whole buffer has been sent.
+     * @param  buffer The characters to be printed on the display
+     * @param  size   The number of characters in the buffer
+     * @return        The number of characters printed
+     */
+    size_t write(const uint8_t *buffer, size_t size) override;
+    using Print::write;
+
+    /**
+     * Prints the supplied text inside a box, wrapping it on word boundaries.
+     * Every line of the box is written from edge to edge, so whatever was in
+     * the box before is overwritten, while nothing outside of it is touched.
+     * If the text does not fit, the last line ends with an ellipsis.
+     * @param  x         The left edge of the box, between 0 and 83
+     * @param  page      The top row of the box, between 0 and 5
+     * @param  width     The width of the box in pixels
+     * @param  pages     The height of the box in rows
+     * @param  string    The text to be printed, `\n` starts a new line
+     * @param  alignment How each line is aligned within the box
+     * @return           True if the text or the box had to be cut | False
+     *                   otherwise
+     */
+    bool printInBox(
+        uint8_t x, uint8_t page, uint8_t width, uint8_t pages,
+        const char *string,
+        nokia_lcd::Alignment alignment = nokia_lcd::Alignment::kLeft);
+
     /**
      * Draws the supplied bitmap on the screen starting at the current cursor
      * location. The bitmap can contain up to 504 bits which is the amount of
@@ -180,6 +483,8 @@ public:
      * provide the desirable result. I got this to work using the
      * `LCD Assistant` utility. For more information and resources please refer
      * to the [Sparkfun Graphic LCD Hookup Guide](https://bit.ly/2IBTtGj).
+     * On any platform, `extras/nokia_lcd_convert.py` converts PBM, PGM and
+     * PNG images into such bitmaps.
      * @param  bitmap            The bitmap to be displayed
      * @param  bitmap_size       The size of the bitmap to be displayed up to
      *                           504 bits
@@ -193,12 +498,86 @@ public:
               const bool read_from_progmem = true,
               const unsigned int bitmap_width = nokia_lcd::kDisplay_max_width);
 
+    /**
+     * Draws the supplied bitmap column by column, starting at the current
+     * cursor location. Suits tall and narrow things, such as bar graphs or
+     * meters: every column is made of `pages` consecutive bytes, from the top
+     * row to the bottom one. When it needs fewer address commands, the
+     * display is switched to vertical addressing, so all the rows of a column
+     * are sent without addressing them.
+     * @param  bitmap            The bitmap to be displayed
+     * @param  bitmap_size       The size of the bitmap to be displayed, a
+     *                           multiple of `pages`
+     * @param  pages             The bitmap height in rows, between 1 and 6
+     * @param  read_from_progmem Whether the bitmap is stored in flash memory
+     *                           instead of SRAM. Default read from flash.
+     * @return                   True if out of bounds error or if nothing was
+     *                           drawn, as the size or the height is invalid |
+     *                           False otherwise
+     */
+    bool drawColumns(const unsigned char bitmap[],
+                     const unsigned int bitmap_size, const uint8_t pages,
+                     const bool read_from_progmem = true);
+
+    /**
+     * Draws a bitmap that is read while it is being drawn, starting at the
+     * current cursor location. The bitmap has the same layout as in `draw()`,
+     * but never needs to be in memory as a whole: it is read in chunks of
+     * `nokia_lcd::kStream_chunk_size` bytes and the bus transaction is kept
+     * open throughout. Drawing stops early if the source runs out of data.
+     * @param  source A stream, e.g. a file or a serial port, to read from
+     * @param  width  The bitmap width
+     * @param  height The bitmap height in pixels, rounded up to whole rows
+     * @return        True if out of bounds error | False otherwise
+     */
+    bool drawStream(Stream &source, const uint8_t width, const uint8_t height);
+
+    using ReadBitmapCallback = unsigned int (*)(unsigned char buffer[],
+                                                unsigned int size);
+    /**
+     * @param  source A function that fills the supplied buffer with up to
+     *                `size` bytes and returns how many it provided
+     * @param  width  The bitmap width
+     * @param  height The bitmap height in pixels, rounded up to whole rows
+     * @return        True if out of bounds error | False otherwise
+     */
+    bool drawStream(ReadBitmapCallback source, const uint8_t width,
+                    const uint8_t height);
+
+    /**
+     * @param  first The iterator to the first byte of the bitmap
+     * @param  last  The iterator past the last byte of the bitmap
+     * @param  width The bitmap width
+     * @return       True if out of bounds error | False otherwise
+     */
+    template <typename Iterator>
+    bool drawStream(Iterator first, Iterator last, const uint8_t width) {
+        return drawChunks(
+            [&first, &last](unsigned char chunk[], unsigned int size) {
+                unsigned int count = 0;
+                while (count < size && first != last) {
+                    chunk[count++] = *first;
+                    ++first;
+                }
+                return count;
+            },
+            kUnknown_bitmap_size, width);
+    }
+
     /**
      * Sends the specified byte as a command to the display.
      * @param command The byte to be sent as a command.
      */
     void sendCommand(const unsigned char command);
 
+    /**
+     * Sends the specified bytes as commands to the display, in a single
+     * transfer with the display selected and in command mode throughout.
+     * @param commands The bytes to be sent as commands.
+     * @param count    The number of commands.
+     */
+    void sendCommands(const unsigned char commands[], const uint8_t count);
+
     /**
      * Sends the specified byte as (presentable) data to the display.
      * @param data           The byte to be sent as presentable data.
@@ -231,6 +610,12 @@ public:
      */
     void setDefaultFont();
 
+    /**
+     * Returns the font currently used to print
+     * @return A pointer to the current LcdFont object
+     */
+    const LcdFont *getFont();
+
     /**
      * @brief Allow the specific display instance to be controlled by another
      * instance, which has been initialized with the same pins except the CE one. 
@@ -241,6 +626,85 @@ public:
     void couple();
     void uncouple();
 
+    /**
+     * Starts a burst transfer. Until the matching `endTransfer()` the display
+     * stays selected and, when hardware SPI is used, the SPI transaction is
+     * kept open so that consecutive bytes are sent back to back. Calls can be
+     * nested, only the outermost pair touches the bus.
+     * @example `lcd.beginTransfer(); lcd.print("a"); lcd.print(1); lcd.endTransfer();`
+     */
+    void beginTransfer();
+
+    /**
+     * Ends a burst transfer started with `beginTransfer()`.
+     */
+    void endTransfer();
+
+#ifdef NOKIA_LCD_ENABLE_STATS
+    /**
+     * Returns what has been sent to the display since the counters were last
+     * reset
+     * @return The counters
+     */
+    const nokia_lcd::Stats &getStats();
+
+    /**
+     * Sets all the counters to zero
+     */
+    void resetStats();
+
+    /**
+     * Prints the counters, one per line
+     * @example `lcd.printStats(Serial);`
+     * @param output Where to print the counters to, e.g. `Serial`
+     */
+    void printStats(Print &output);
+#endif
+
+#ifdef NOKIA_LCD_ENABLE_TRACE
+    /**
+     * Writes the recorded trace in a compact binary format: the "NLTR" magic,
+     * a version byte, the number of entries and the number of entries that
+     * were overwritten because the trace was full (both as 16-bit little
+     * endian), followed by the entries from the oldest to the newest, two
+     * bytes each (`flags`, `value`).
+     * @example `lcd.exportTrace(Serial);`
+     * @param output Where to write the trace to, e.g. `Serial`
+     */
+    void exportTrace(Print &output);
+
+    /**
+     * Discards the recorded trace
+     */
+    void clearTrace();
+#endif
+
+#ifdef NOKIA_LCD_ENABLE_ROTATION
+    /**
+     * Rotates and mirrors everything that is drawn or printed from now on.
+     * When rotated by 90 or 270 degrees, the screen is 48 pixels wide and has
+     * 10 rows, the last 4 pixels are not used. What is drawn is sent in
+     * blocks of 8 columns, whose other columns are taken from a copy of what
+     * was sent to the display, since it cannot be read.
+     * The cursor returns to (0,0).
+     * @param rotation The clockwise rotation
+     * @param mirrored Whether to also flip what is shown from left to right
+     */
+    void setRotation(nokia_lcd::Rotation rotation, bool mirrored = false);
+
+    /**
+     * Returns the width of the screen, as it is currently rotated
+     * @return The width in pixels
+     */
+    uint8_t getWidth();
+
+    /**
+     * Returns the height of the screen, as it is currently rotated
+     * @return The height in pixels
+     */
+    uint8_t getHeight();
+#endif
+
 private:
     /**
      * Sends the specified byte to the LCD via software SPI as data or a
@@ -266,6 +730,8 @@ private:
     /**
      * Updates mX_cursor and mY_cursor position. By default it uses the whole
      * screen width in order to calculate row changing and out of bounds.
+     * With vertical addressing, the cursor moves down the rows first and then
+     * on to the next column, so the row positions are used instead.
      *
      * @param x_start_position      Left alignment position. Used for drawing
      *                              bitmaps smaller than screen width. Defaults
@@ -273,10 +739,32 @@ private:
      * @param x_end_position        Position where the cursor will consider a
      * line breaking. When drawing a bitmap, it is the image width. Defaults to
      * screen width.
+     * @param y_start_position      Top row, where the next column starts when
+     * using vertical addressing. Defaults to zero.
+     * @param y_end_position        Row where the cursor will move on to the
+     * next column when using vertical addressing. Defaults to screen height.
      */
     bool updateCursorPosition(
         const unsigned int x_start_position = 0,
-        const unsigned int x_end_position = nokia_lcd::kDisplay_max_width);
+        const unsigned int x_end_position = nokia_lcd::kDisplay_max_width,
+        const uint8_t y_start_position = 0,
+        const uint8_t y_end_position = nokia_lcd::kDisplay_max_rows);
+
+    /**
+     * Switches the display between horizontal and vertical addressing, if it
+     * is not already using the requested one.
+     * @param vertical Whether to use vertical addressing
+     */
+    void setAddressing(const bool vertical);
+
+    /**
+     * Sends a byte of a bitmap, inverted if requested.
+     * @param bitmap            The bitmap
+     * @param index             The index of the byte within the bitmap
+     * @param read_from_progmem Whether the bitmap is stored in flash memory
+     */
+    void sendBitmapByte(const unsigned char bitmap[], const unsigned int index,
+                        const bool read_from_progmem);
 
     /**
      * Prints the specified character
@@ -285,11 +773,272 @@ private:
      */
     bool printCharacter(char character);
 
+    /**
+     * Prints a glyph followed by the spacing of the font
+     * @param  glyph The glyph to be printed
+     * @return       True if out of bounds error | False otherwise
+     */
+    bool printGlyph(const LcdGlyph &glyph);
+
+    /**
+     * Prints the digits of a number, most significant first, without
+     * formatting it into a buffer
+     * @param  number     The number to be printed
+     * @param  min_digits Pads the number with leading zeros up to this many
+     *                    digits
+     * @param  base       Between 2 and 36, e.g. 16 for hexadecimal digits
+     * @param  uppercase  Whether digits above 9 are uppercase letters
+     * @return            True if out of bounds error | False otherwise
+     */
+    bool printDigits(unsigned long number, const uint8_t min_digits = 1,
+                     const uint8_t base = 10, const bool uppercase = false);
+
+    /**
+     * Prints formatted text, see `printf()`
+     * @param  format            The format
+     * @param  read_from_progmem Whether the format is stored in flash memory
+     * @param  arguments         The values to be formatted
+     * @return                   True if out of bounds error | False otherwise
+     */
+    bool printFormatted(const char *format, const bool read_from_progmem,
+                        va_list arguments);
+
+    /**
+     * Prints the same character several times, e.g. to pad a field
+     * @param  character The character to be printed
+     * @param  count     How many times it is printed
+     * @return           True if out of bounds error | False otherwise
+     */
+    bool printRepeated(const char character, unsigned int count);
+
+    /**
+     * Draws the columns of a glyph at the current cursor location, wrapping
+     * at the edge of the screen like any text
+     * @param  glyph   The glyph
+     * @param  columns How many of its columns are drawn
+     * @param  first   The first of its columns that is drawn
+     * @return         True if out of bounds error | False otherwise
+     */
+    bool drawGlyph(const LcdGlyph &glyph, const uint8_t columns,
+                   const uint8_t first = 0);
+
+    /**
+     * Draws the supplied bitmap bytes. Unlike `draw()` the left alignment
+     * position is supplied, so that a bitmap can be drawn in several parts.
+     * @param  bitmap            The bitmap bytes to be displayed
+     * @param  bitmap_size       The number of bytes to be displayed
+     * @param  read_from_progmem Whether the bytes are stored in flash memory
+     * @param  x_start_position  Left alignment position of the bitmap
+     * @param  bitmap_width      The bitmap width
+     * @return                   True if out of bounds error | False otherwise
+     */
+    bool drawBytes(const unsigned char bitmap[], const unsigned int bitmap_size,
+                   const bool read_from_progmem,
+                   const unsigned int x_start_position,
+                   const unsigned int bitmap_width);
+
+    /**
+     * Draws a bitmap that is provided in chunks by the reader.
+     * @param  read        Called with a buffer and its size, returns how many
+     *                     bytes it placed in the buffer
+     * @param  bitmap_size The bitmap size or `kUnknown_bitmap_size` to draw
+     *                     until the reader runs out of data
+     * @param  width       The bitmap width
+     * @return             True if out of bounds error | False otherwise
+     */
+    template <typename Reader>
+    bool drawChunks(Reader read, unsigned int bitmap_size,
+                    const uint8_t width) {
+        const unsigned int x_start = mX_cursor;
+        unsigned char chunk[nokia_lcd::kStream_chunk_size];
+        bool out_of_bounds = false;
+        beginTransfer();
+        while (bitmap_size > 0) {
+            const unsigned int requested =
+                bitmap_size < sizeof(chunk) ? bitmap_size : sizeof(chunk);
+            const unsigned int received = read(chunk, requested);
+            out_of_bounds =
+                drawBytes(chunk, received, false, x_start, width) ||
+                out_of_bounds;
+            if (received < requested) {
+                break;
+            }
+            bitmap_size -= received;
+        }
+        endTransfer();
+
+        return out_of_bounds;
+    }
+
+    /**
+     * Prints the specified code point, leaving out any columns that do not fit
+     * @param code_point The code point to be printed
+     * @param remaining  How many columns may still be drawn, updated on return
+     */
+    void printClipped(uint16_t code_point, uint8_t &remaining);
+
+    /**
+     * Prints the specified code point, leaving out any columns that are left
+     * of the screen or do not fit
+     * @param code_point The code point to be printed
+     * @param hidden     How many columns are still left of the screen,
+     *                   updated on return
+     * @param remaining  How many columns may still be drawn, updated on return
+     */
+    void printClipped(uint16_t code_point, unsigned int &hidden,
+                      uint8_t &remaining);
+
+    /**
+     * Draws empty columns in the current background color
+     * @param count How many columns to draw
+     */
+    void drawBlank(uint8_t count);
+
+    /**
+     * Sets the data or command pin, unless it is already known to be in the
+     * requested state during the current transfer.
+     * @param is_data Whether data (or a command) will be sent next
+     */
+    void setDataMode(const bool is_data);
+
+    /**
+     * Sends the cached display settings.
+     */
+    void sendSettings();
+
+    /**
+     * Sends an extended instruction, which requires switching to the extended
+     * instruction set and back.
+     * @param command The extended instruction
+     */
+    void sendExtendedCommand(const unsigned char command);
+
+    /**
+     * Returns the function set instruction for the current addressing mode,
+     * which keeps the display powered down while it is asleep
+     * @param  flags Additional flags, e.g. to select the extended instructions
+     * @return       The function set instruction
+     */
+    unsigned char functionSet(const uint8_t flags = 0);
+
+    /**
+     * Sends the specified byte to the LCD as it is, regardless of the cursor
+     * @param lcd_byte The byte to be send to the LCD
+     * @param is_data  Whether the byte to be send is data (or a command)
+     */
+    void transmit(const unsigned char lcd_byte, const bool is_data);
+
+    /**
+     * Sets the address of the next byte sent to the display
+     * @param x The column, between 0 and 83
+     * @param y The row, between 0 and 5
+     */
+    void addressDisplay(const uint8_t x, const uint8_t y);
+
+    /**
+     * Returns the number of columns, as the screen is currently rotated
+     * @return The number of columns
+     */
+    uint8_t columns() const {
+#ifdef NOKIA_LCD_ENABLE_ROTATION
+        return mPortrait ? nokia_lcd::kDisplay_max_height
+                         : nokia_lcd::kDisplay_max_width;
+#else
+        return nokia_lcd::kDisplay_max_width;
+#endif
+    }
+
+    /**
+     * Returns the number of rows, as the screen is currently rotated
+     * @return The number of rows
+     */
+    uint8_t rows() const {
+#ifdef NOKIA_LCD_ENABLE_ROTATION
+        return mPortrait ? nokia_lcd::kDisplay_max_width / 8
+                         : nokia_lcd::kDisplay_max_rows;
+#else
+        return nokia_lcd::kDisplay_max_rows;
+#endif
+    }
+
+#ifdef NOKIA_LCD_ENABLE_ROTATION
+    /**
+     * Keeps a byte drawn while the screen is rotated in the block of 8
+     * columns it belongs to, sending the previous block if it is another one
+     * @param data The byte, at the current cursor location
+     */
+    void stash(const unsigned char data);
+
+    /**
+     * Sends the block of 8 columns drawn last, rotated, if it has changed
+     */
+    void flushTile();
+
+    /**
+     * Sends a byte as data to a location of the display, keeping the copy of
+     * its memory up to date
+     * @param data The byte
+     * @param x    The column of the display
+     * @param page The row of the display
+     */
+    void transmitTo(const unsigned char data, const uint8_t x,
+                    const uint8_t page);
+#endif
+
+#ifdef NOKIA_LCD_ENABLE_TRACE
+    /**
+     * Records a byte or a chip select change, overwriting the oldest entry
+     * when the trace is full
+     * @param flags `kTrace_data` and `kTrace_ce`
+     * @param value The byte or the new chip select pin level
+     */
+    void record(const uint8_t flags, const uint8_t value);
+#endif
+
+    static const uint8_t kUnknown_data_mode = 0xFF;
+    static const unsigned int kUnknown_bitmap_size = ~0U;
     bool mCoupled = false;
+    uint8_t mTransferDepth = 0;
+    uint8_t mDataMode = kUnknown_data_mode;
     const uint8_t kClk_pin, kDin_pin, kDc_pin, kCe_pin, kRst_pin, kBl_pin;
     bool mInverted = false;
     const bool kUsingBacklight;
     const bool kUsingHardwareSPI;
     uint8_t mX_cursor, mY_cursor;
     const LcdFont *mCurrentFont;
+    // Display settings, cached so they can be restored after a power-down
+    uint8_t mContrast;
+    uint8_t mTemperatureCoefficient;
+    uint8_t mBias;
+    uint8_t mDisplayControl;
+    bool mVertical_addressing;
+    bool mPowered_down;  // Kept in every function set until `wake()`
+    Utf8Decoder mDecoder;  // Text may be written one byte at a time
+#ifdef NOKIA_LCD_ENABLE_STATS
+    nokia_lcd::Stats mStats{};
+#endif
+#ifdef NOKIA_LCD_ENABLE_TRACE
+    nokia_lcd::TraceEntry mTrace[nokia_lcd::kTrace_capacity];
+    uint16_t mTrace_start = 0;
+    uint16_t mTrace_size = 0;
+    uint16_t mTrace_dropped = 0;
+#endif
+#ifdef NOKIA_LCD_ENABLE_ROTATION
+    static const uint8_t kTile_size = 8;
+    static const uint8_t kNo_tile = 0xFF;
+    nokia_lcd::Rotation mRotation = nokia_lcd::Rotation::k0;
+    bool mMirrored = false;
+    bool mRotated = false;  // Whether bytes cannot be sent as they are
+    bool mPortrait = false;
+    // The last block of 8 columns drawn on, in rotated coordinates
+    unsigned char mTile[kTile_size];
+    uint8_t mTile_x = kNo_tile;
+    uint8_t mTile_y = 0;
+    uint8_t mTile_used = 0;  // A bit for each column drawn on
+    bool mTile_dirty = false;
+    // What was sent to the display, as it is not rotated, since the display
+    // cannot be read back when a block is only partly drawn on
+    unsigned char mDisplay_ram[nokia_lcd::kDisplay_max_rows]
+                              [nokia_lcd::kDisplay_max_width] = {};
+#endif
 };
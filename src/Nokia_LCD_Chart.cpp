@@ -0,0 +1,226 @@
+#include "Nokia_LCD_Chart.h"
+
+namespace {
+const uint8_t kRows_per_page = 8;
+const int32_t kSample_min = -32768;
+const int32_t kSample_max = 32767;
+// The columns sent at once in the sweep mode, the new sample and the gap
+const uint8_t kSweep_columns = 2;
+
+// Returns how much of a span that starts at `start` fits below `limit`
+uint8_t fitting(uint8_t start, uint8_t length, uint8_t limit) {
+    if (start >= limit) {
+        return 0;
+    }
+
+    return length < limit - start ? length : limit - start;
+}
+}  // namespace
+
+Nokia_LCD_Chart::Nokia_LCD_Chart(Nokia_LCD &lcd, int16_t samples[],
+                                 uint8_t width, uint8_t x, uint8_t page,
+                                 uint8_t pages)
+    : mLcd{lcd},
+      mSamples{samples},
+      // A chart that does not fit on the screen is cut at its edges
+      kWidth{fitting(x, width, nokia_lcd::kDisplay_max_width)},
+      kX{x},
+      kPage{page},
+      kPages{fitting(page, pages, nokia_lcd::kDisplay_max_rows)},
+      mMode{nokia_lcd::ChartMode::kScroll},
+      mAutoscale{true},
+      mNeeds_redraw{true},
+      mMin{0},
+      mMax{1},
+      mHead{0},
+      mCount{0} {}
+
+void Nokia_LCD_Chart::setMode(nokia_lcd::ChartMode mode) {
+    if (mode != mMode) {
+        mMode = mode;
+        mNeeds_redraw = true;
+    }
+}
+
+void Nokia_LCD_Chart::setRange(int16_t min, int16_t max) {
+    mAutoscale = false;
+    mMin = min < max ? min : max;
+    mMax = min < max ? max : min;
+    // A flat range would divide by zero
+    if (mMin == mMax && mMax < kSample_max) {
+        mMax++;
+    } else if (mMin == mMax) {
+        mMin--;
+    }
+    mNeeds_redraw = true;
+}
+
+void Nokia_LCD_Chart::setAutoscale() {
+    mAutoscale = true;
+    mNeeds_redraw = autoscale() || mNeeds_redraw;
+}
+
+void Nokia_LCD_Chart::clear() {
+    mHead = 0;
+    mCount = 0;
+    mNeeds_redraw = true;
+}
+
+bool Nokia_LCD_Chart::add(int16_t sample) {
+    if (kWidth == 0 || kPages == 0) {
+        return true;
+    }
+    const uint8_t column = mHead;
+    mSamples[mHead] = sample;
+    mHead = mHead + 1 < kWidth ? mHead + 1 : 0;
+    if (mCount < kWidth) {
+        mCount++;
+    }
+
+    if (mAutoscale && autoscale()) {
+        mNeeds_redraw = true;
+    }
+    // Every column moves in the scroll mode
+    if (mNeeds_redraw || mMode == nokia_lcd::ChartMode::kScroll) {
+        return redraw();
+    }
+
+    return drawSweep(column);
+}
+
+bool Nokia_LCD_Chart::redraw() {
+    mNeeds_redraw = false;
+    bool out_of_bounds = false;
+    mLcd.beginTransfer();
+    for (uint8_t page = 0; page < kPages; page++) {
+        // Anything sent without a cursor would land somewhere else
+        if (!mLcd.setCursor(kX, kPage + page)) {
+            out_of_bounds = true;
+            continue;
+        }
+        for (uint8_t column = 0; column < kWidth; column++) {
+            out_of_bounds =
+                mLcd.sendData(render(column, page)) || out_of_bounds;
+        }
+    }
+    mLcd.endTransfer();
+
+    return out_of_bounds;
+}
+
+int16_t Nokia_LCD_Chart::getMin() { return mMin; }
+
+int16_t Nokia_LCD_Chart::getMax() { return mMax; }
+
+bool Nokia_LCD_Chart::autoscale() {
+    if (mCount == 0) {
+        return false;
+    }
+    int16_t lowest = mSamples[0];
+    int16_t highest = mSamples[0];
+    for (uint8_t i = 1; i < mCount; i++) {
+        lowest = mSamples[i] < lowest ? mSamples[i] : lowest;
+        highest = mSamples[i] > highest ? mSamples[i] : highest;
+    }
+
+    // Keep the range while the samples fit and take up at least half of it
+    const int32_t span = static_cast<int32_t>(highest) - lowest;
+    const int32_t range = static_cast<int32_t>(mMax) - mMin;
+    if (lowest >= mMin && highest <= mMax && span * 2 >= range) {
+        return false;
+    }
+    // Leave some room, so that the next samples are likely to fit too
+    const int32_t margin = span / 4 > 0 ? span / 4 : 1;
+    const int32_t min = lowest - margin;
+    const int32_t max = highest + margin;
+    mMin = min > kSample_min ? min : kSample_min;
+    mMax = max < kSample_max ? max : kSample_max;
+
+    return true;
+}
+
+bool Nokia_LCD_Chart::sampleAt(uint8_t column, int16_t &sample) {
+    unsigned int index = column;
+    if (mMode == nokia_lcd::ChartMode::kScroll) {
+        // The oldest sample is on the left and the newest one on the right
+        const uint8_t empty = kWidth - mCount;
+        if (column < empty) {
+            return false;
+        }
+        index = mCount < kWidth ? column - empty : mHead + column;
+        if (index >= kWidth) {
+            index -= kWidth;
+        }
+    } else if (column >= mCount || column == mHead) {
+        // Beyond the samples so far or the gap that precedes the oldest one
+        return false;
+    }
+    sample = mSamples[index];
+
+    return true;
+}
+
+unsigned char Nokia_LCD_Chart::render(uint8_t column, uint8_t page) {
+    int16_t sample;
+    if (!sampleAt(column, sample)) {
+        return 0x00;
+    }
+    uint8_t top = toPixel(sample);
+    uint8_t bottom = top;
+    int16_t previous;
+    if (column > 0 && sampleAt(column - 1, previous)) {
+        const uint8_t y = toPixel(previous);
+        top = y < top ? y : top;
+        bottom = y > bottom ? y : bottom;
+    }
+
+    const uint8_t page_top = page * kRows_per_page;
+    const uint8_t page_bottom = page_top + kRows_per_page - 1;
+    if (top > page_bottom || bottom < page_top) {
+        return 0x00;
+    }
+    const uint8_t first = top > page_top ? top - page_top : 0;
+    const uint8_t last =
+        bottom < page_bottom ? bottom - page_top : kRows_per_page - 1;
+
+    return (0xFF << first) & (0xFF >> (kRows_per_page - 1 - last));
+}
+
+uint8_t Nokia_LCD_Chart::toPixel(int16_t value) {
+    const int32_t bottom = kPages * kRows_per_page - 1;
+    if (value <= mMin) {
+        return bottom;
+    }
+    if (value >= mMax) {
+        return 0;
+    }
+
+    return bottom - (static_cast<int32_t>(value) - mMin) * bottom /
+                        (static_cast<int32_t>(mMax) - mMin);
+}
+
+bool Nokia_LCD_Chart::drawSweep(uint8_t column) {
+    // The column of the new sample and the gap after it, unless the gap wraps
+    // around to the first column. Sent as they are, like in `redraw()`.
+    const uint8_t count = column + 1 < kWidth ? kSweep_columns : 1;
+    bool out_of_bounds = false;
+    mLcd.beginTransfer();
+    for (uint8_t page = 0; page < kPages; page++) {
+        // Anything sent without a cursor would land somewhere else
+        if (!mLcd.setCursor(kX + column, kPage + page)) {
+            out_of_bounds = true;
+            continue;
+        }
+        for (uint8_t i = 0; i < count; i++) {
+            out_of_bounds =
+                mLcd.sendData(render(column + i, page)) || out_of_bounds;
+        }
+        if (count < kSweep_columns) {
+            mLcd.setCursor(kX, kPage + page);
+            out_of_bounds = mLcd.sendData(render(0, page)) || out_of_bounds;
+        }
+    }
+    mLcd.endTransfer();
+
+    return out_of_bounds;
+}
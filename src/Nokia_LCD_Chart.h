@@ -0,0 +1,144 @@
+/**
+ * A chart of the latest samples of a value, e.g. a temperature, drawn as a
+ * line across a part of the display.
+ *
+ * The samples are kept in a ring buffer provided by the sketch, one sample
+ * for every column of the chart. In the scroll mode the newest sample is
+ * always on the right, so the whole chart moves left with every new sample.
+ * In the sweep mode, like on an oscilloscope, the samples stay where they
+ * were drawn and a gap sweeps across the chart: only the column of the new
+ * sample and the gap after it are sent, each row of them after a single
+ * address command. The chart is sent as it is drawn, so
+ * `Nokia_LCD::setInverted()` does not affect it.
+ * The range of the chart follows the samples, but it only changes when the
+ * samples leave it or shrink to less than half of it, so that the chart is
+ * not redrawn with every sample.
+ */
+#pragma once
+#include <stdint.h>
+
+#include "Nokia_LCD.h"
+
+namespace nokia_lcd {
+// How new samples are shown
+enum class ChartMode : uint8_t { kScroll, kSweep };
+}  // namespace nokia_lcd
+
+class Nokia_LCD_Chart {
+public:
+    /**
+     * Nokia_LCD_Chart constructor. A chart that does not fit on the screen
+     * is cut at its right and bottom edges.
+     * @param lcd     The (initialized) display the chart is drawn on
+     * @param samples The buffer the samples are kept in, one for each column
+     * @param width   The width of the chart, as well as of the buffer
+     * @param x       The left edge of the chart, between 0 and 83
+     * @param page    The top row of the chart, between 0 and 5
+     * @param pages   The height of the chart in rows
+     */
+    Nokia_LCD_Chart(Nokia_LCD &lcd, int16_t samples[], uint8_t width,
+                    uint8_t x = 0, uint8_t page = 0,
+                    uint8_t pages = nokia_lcd::kDisplay_max_rows);
+
+    /**
+     * Sets how new samples are shown. The chart is redrawn with the next
+     * sample.
+     * @param mode Either `nokia_lcd::ChartMode::kScroll` (default) or
+     *             `nokia_lcd::ChartMode::kSweep`
+     */
+    void setMode(nokia_lcd::ChartMode mode);
+
+    /**
+     * Sets a fixed range, samples outside of it are drawn at its edges
+     * @param min The value at the bottom of the chart
+     * @param max The value at the top of the chart
+     */
+    void setRange(int16_t min, int16_t max);
+
+    /**
+     * Makes the range follow the samples again, which is the default
+     */
+    void setAutoscale();
+
+    /**
+     * Forgets all the samples. The chart is cleared with the next sample.
+     */
+    void clear();
+
+    /**
+     * Adds a sample and draws it
+     * @param  sample The sample
+     * @return        True if out of bounds error | False otherwise
+     */
+    bool add(int16_t sample);
+
+    /**
+     * Draws the whole chart
+     * @return True if out of bounds error | False otherwise
+     */
+    bool redraw();
+
+    /**
+     * Returns the value at the bottom of the chart
+     * @return The value
+     */
+    int16_t getMin();
+
+    /**
+     * Returns the value at the top of the chart
+     * @return The value
+     */
+    int16_t getMax();
+
+private:
+    /**
+     * Adapts the range to the samples, if they left it or shrank too much
+     * @return True if the range changed | False otherwise
+     */
+    bool autoscale();
+
+    /**
+     * Returns the sample shown on a column
+     * @param  column The column of the chart
+     * @param  sample Where the sample is stored
+     * @return        True if the column shows a sample | False otherwise
+     */
+    bool sampleAt(uint8_t column, int16_t &sample);
+
+    /**
+     * Returns the pixels of a column within a row, which connect its sample
+     * to the sample of the column on its left
+     * @param  column The column of the chart
+     * @param  page   The row of the chart
+     * @return        The pixels, the top one is the lowest bit
+     */
+    unsigned char render(uint8_t column, uint8_t page);
+
+    /**
+     * Returns the pixel on the y-axis of the chart that shows a value
+     * @param  value The value
+     * @return       The pixel, 0 is the top one
+     */
+    uint8_t toPixel(int16_t value);
+
+    /**
+     * Draws a column and the next one, i.e. the new sample and the gap
+     * @param  column The column of the chart
+     * @return        True if out of bounds error | False otherwise
+     */
+    bool drawSweep(uint8_t column);
+
+    Nokia_LCD &mLcd;
+    int16_t *mSamples;
+    const uint8_t kWidth;
+    const uint8_t kX;
+    const uint8_t kPage;
+    const uint8_t kPages;
+    nokia_lcd::ChartMode mMode;
+    bool mAutoscale;
+    bool mNeeds_redraw;
+    int16_t mMin;
+    int16_t mMax;
+    uint8_t mHead;   // Where the next sample is stored
+    uint8_t mCount;  // How many samples are stored
+};
@@ -0,0 +1,188 @@
+#include "Nokia_LCD_Console.h"
+
+#include <string.h>
+
+namespace {
+const uint8_t kBlank = ' ';
+const uint8_t kAll_rows_dirty = (1 << nokia_lcd::kConsole_lines) - 1;
+
+// Every character of a line takes a single byte. ASCII, and every byte for
+// fonts that do not decode UTF-8, is kept as it is. A code point beyond ASCII
+// is kept as its position among the glyphs of the font, above 0x80, where
+// the last one stands for the code points the font has no glyph for.
+uint8_t toCell(const LcdFont *font, uint16_t code_point) {
+    if (code_point < 0x80 || !font->isUtf8()) {
+        return code_point;
+    }
+
+    return 0x80 | font->getExtendedIndex(code_point);
+}
+
+// Prints a character of a line, encoded in UTF-8 again if beyond ASCII and
+// if the font decodes it
+void printCell(Nokia_LCD &lcd, uint8_t cell) {
+    const LcdFont *font = lcd.getFont();
+    if (cell < 0x80 || !font->isUtf8()) {
+        lcd.print(static_cast<char>(cell));
+        return;
+    }
+    // Missing code points are shown with the fallback glyph of the font
+    const uint16_t code_point = font->getIndexedCodePoint(cell & 0x7F);
+    char encoded[4];
+    if (code_point < 0x800) {
+        encoded[0] = 0xC0 | code_point >> 6;
+        encoded[1] = 0x80 | (code_point & 0x3F);
+        encoded[2] = '\0';
+    } else {
+        encoded[0] = 0xE0 | code_point >> 12;
+        encoded[1] = 0x80 | (code_point >> 6 & 0x3F);
+        encoded[2] = 0x80 | (code_point & 0x3F);
+        encoded[3] = '\0';
+    }
+    lcd.print(encoded);
+}
+}  // namespace
+
+Nokia_LCD_Console::Nokia_LCD_Console(Nokia_LCD &lcd)
+    : mLcd{lcd}, mTop{0}, mRow{0}, mColumn{0}, mDirty{0} {
+    for (uint8_t row = 0; row < nokia_lcd::kConsole_lines; row++) {
+        blankLine(mLines[row]);
+    }
+}
+
+void Nokia_LCD_Console::clear() {
+    for (uint8_t row = 0; row < nokia_lcd::kConsole_lines; row++) {
+        blankLine(mLines[row]);
+    }
+    mDecoder = Utf8Decoder();
+    mTop = 0;
+    mRow = 0;
+    mColumn = 0;
+    mDirty = 0;
+    mLcd.clear();
+}
+
+void Nokia_LCD_Console::print(const char *string) {
+    while (*string != '\0') {
+        putCharacter(*string++);
+    }
+    redraw();
+}
+
+void Nokia_LCD_Console::print(char character) {
+    putCharacter(character);
+    redraw();
+}
+
+void Nokia_LCD_Console::println(const char *string) {
+    while (*string != '\0') {
+        putCharacter(*string++);
+    }
+    putCharacter('\n');
+    redraw();
+}
+
+void Nokia_LCD_Console::println(char character) {
+    putCharacter(character);
+    putCharacter('\n');
+    redraw();
+}
+
+void Nokia_LCD_Console::putCharacter(char character) {
+    // A character beyond ASCII takes a single column once it is decoded
+    uint16_t code_point;
+    if (!mLcd.getFont()->decode(mDecoder, character, code_point)) {
+        return;
+    }
+    if (code_point == '\n') {
+        newLine();
+        return;
+    }
+    if (code_point == '\r') {
+        return;
+    }
+
+    // Wrap long lines instead of overwriting the beginning of the row
+    if (mColumn >= columns()) {
+        newLine();
+    }
+    uint8_t *current_line = line(mRow);
+    const uint8_t cell = toCell(mLcd.getFont(), code_point);
+    if (current_line[mColumn] != cell) {
+        current_line[mColumn] = cell;
+        mDirty |= 1 << mRow;
+    }
+    mColumn++;
+}
+
+void Nokia_LCD_Console::newLine() {
+    mColumn = 0;
+    if (mRow + 1 < nokia_lcd::kConsole_lines) {
+        mRow++;
+        return;
+    }
+
+    // Scroll by one line. A row only needs to be redrawn if it was already
+    // pending or if the line moving into it differs from the one it shows.
+    uint8_t dirty = mDirty & (1 << (nokia_lcd::kConsole_lines - 1));
+    for (uint8_t row = 0; row + 1 < nokia_lcd::kConsole_lines; row++) {
+        if ((mDirty & (1 << row)) ||
+            memcmp(line(row), line(row + 1),
+                   nokia_lcd::kConsole_columns) != 0) {
+            dirty |= 1 << row;
+        }
+    }
+
+    // The last row becomes blank, which only matters if it was not already
+    const uint8_t *old_last_line = line(nokia_lcd::kConsole_lines - 1);
+    for (uint8_t column = 0; column < nokia_lcd::kConsole_columns; column++) {
+        if (old_last_line[column] != kBlank) {
+            dirty |= 1 << (nokia_lcd::kConsole_lines - 1);
+        }
+    }
+    // The line that was on the first row is reused for the new last row
+    blankLine(line(0));
+    mTop = (mTop + 1) % nokia_lcd::kConsole_lines;
+    mDirty = dirty & kAll_rows_dirty;
+}
+
+void Nokia_LCD_Console::redraw() {
+    if (mDirty == 0) {
+        return;
+    }
+
+    const uint8_t line_columns = columns();
+    mLcd.beginTransfer();
+    for (uint8_t row = 0; row < nokia_lcd::kConsole_lines; row++) {
+        if (!(mDirty & (1 << row))) {
+            continue;
+        }
+        // Lines are padded with blanks, so a redrawn row never needs a clear
+        mLcd.setCursor(0, row);
+        const uint8_t *current_line = line(row);
+        for (uint8_t column = 0; column < line_columns; column++) {
+            printCell(mLcd, current_line[column]);
+        }
+    }
+    mLcd.endTransfer();
+    mDirty = 0;
+}
+
+void Nokia_LCD_Console::blankLine(uint8_t *current_line) {
+    for (uint8_t column = 0; column < nokia_lcd::kConsole_columns; column++) {
+        current_line[column] = kBlank;
+    }
+}
+
+uint8_t *Nokia_LCD_Console::line(uint8_t row) {
+    return mLines[(mTop + row) % nokia_lcd::kConsole_lines];
+}
+
+uint8_t Nokia_LCD_Console::columns() const {
+    const LcdFont *font = mLcd.getFont();
+    const uint8_t fitting =
+        nokia_lcd::kDisplay_max_width / (font->columnSize + font->hSpaceSize);
+
+    return fitting < nokia_lcd::kConsole_columns ? fitting
+                                                 : nokia_lcd::kConsole_columns;
+}
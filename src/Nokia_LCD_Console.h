@@ -0,0 +1,101 @@
+/**
+ * A scrolling text console on top of a Nokia_LCD.
+ *
+ * The console remembers the characters of the lines currently on screen, so
+ * when the last line is full it can move everything one line up, instead of
+ * starting over from the top of the display. Only the lines whose content
+ * actually changed are sent to the display again. Text is decoded from UTF-8,
+ * so every character, e.g. `°` or `µ`, takes a single column of the console
+ * and a single byte of its memory. A character beyond ASCII is kept as its
+ * position among the glyphs of the current font, see
+ * `LcdFont::getExtendedIndex()`, so the font should not change while it is
+ * shown.
+ */
+#pragma once
+#include <stdint.h>
+
+#include "Nokia_LCD.h"
+
+namespace nokia_lcd {
+// Console constants, one line per row of the display and as many columns as
+// characters of the default font fit in its width
+const uint8_t kConsole_lines = kDisplay_max_rows;
+const uint8_t kConsole_columns =
+    kDisplay_max_width / (kDefault_glyph_width + kDefault_glyph_spacing);
+}  // namespace nokia_lcd
+
+class Nokia_LCD_Console {
+public:
+    /**
+     * Nokia_LCD_Console constructor
+     * @param lcd The (initialized) display the console is printed on
+     */
+    Nokia_LCD_Console(Nokia_LCD &lcd);
+
+    /**
+     * Clears the console and the display. The cursor shall return to the
+     * beginning of the first line.
+     */
+    void clear();
+
+    /**
+     * Prints the supplied element at the end of the console. When the last line
+     * is full the console scrolls up by one line.
+     * @param string The string to be printed on the console
+     */
+    void print(const char *string);
+    void print(char character);
+
+    /**
+     * Prints the supplied element at the end of the console and goes to the
+     * next line.
+     * @param string The string to be printed on the console
+     */
+    void println(const char *string);
+    void println(char character);
+
+private:
+    /**
+     * Adds the character to the line buffer without updating the display.
+     * Bytes of a UTF-8 sequence are collected until the code point completes.
+     * @param character The character to be added
+     */
+    void putCharacter(char character);
+
+    /**
+     * Fills a line with blanks
+     * @param current_line The line to be cleared
+     */
+    static void blankLine(uint8_t *current_line);
+
+    /**
+     * Moves to the beginning of the next line, scrolling if needed.
+     */
+    void newLine();
+
+    /**
+     * Sends the lines that have changed since they were last drawn.
+     */
+    void redraw();
+
+    /**
+     * Returns the line buffer that is shown on the specified display row
+     * @param  row The display row
+     * @return     The characters of the line
+     */
+    uint8_t *line(uint8_t row);
+
+    /**
+     * Returns how many characters of the current font fit in a line
+     * @return The characters per line
+     */
+    uint8_t columns() const;
+
+    Nokia_LCD &mLcd;
+    uint8_t mLines[nokia_lcd::kConsole_lines][nokia_lcd::kConsole_columns];
+    Utf8Decoder mDecoder;
+    uint8_t mTop;     // Index of the line shown on the first row
+    uint8_t mRow;     // Row the next character goes to
+    uint8_t mColumn;  // Column the next character goes to
+    uint8_t mDirty;   // One bit per row that needs to be redrawn
+};
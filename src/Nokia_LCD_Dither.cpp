@@ -0,0 +1,105 @@
+#include "Nokia_LCD_Dither.h"
+
+#include <string.h>
+
+namespace {
+const uint8_t kRows_per_page = 8;
+const int16_t kMid_gray = 128;
+const int16_t kWhite = 255;
+
+// Thresholds of a 4x4 Bayer matrix, spread evenly between 0 and 255
+const uint8_t kBayer_size = 4;
+const uint8_t kBayer_thresholds[kBayer_size][kBayer_size] = {
+    {8, 136, 40, 168},
+    {200, 72, 232, 104},
+    {56, 184, 24, 152},
+    {248, 120, 216, 88}};
+}  // namespace
+
+Nokia_LCD_Dither::Nokia_LCD_Dither(Nokia_LCD &lcd) : mLcd{lcd} {}
+
+bool Nokia_LCD_Dither::drawOrdered(ReadGrayRowCallback source, uint8_t width,
+                                   uint8_t height) {
+    return draw(source, width, height, false);
+}
+
+bool Nokia_LCD_Dither::drawDiffused(ReadGrayRowCallback source,
+                                    uint8_t width, uint8_t height) {
+    return draw(source, width, height, true);
+}
+
+bool Nokia_LCD_Dither::draw(ReadGrayRowCallback source, uint8_t width,
+                            uint8_t height, bool diffusion) {
+    if (width == 0) {
+        return false;
+    }
+    if (width > nokia_lcd::kDisplay_max_width) {
+        width = nokia_lcd::kDisplay_max_width;
+    }
+    if (height > nokia_lcd::kDisplay_max_height) {
+        height = nokia_lcd::kDisplay_max_height;
+    }
+    memset(mErrors, 0, sizeof(mErrors));
+    // Only needed while the image is drawn
+    uint8_t row[nokia_lcd::kDisplay_max_width];
+    unsigned char page[nokia_lcd::kDisplay_max_width];
+
+    bool out_of_bounds = false;
+    mLcd.beginTransfer();
+    for (uint8_t y = 0; y < height; y++) {
+        if (y % kRows_per_page == 0) {
+            memset(page, 0, width);
+        }
+        source(y, row, width);
+        if (diffusion) {
+            diffuseRow(y, row, page, width);
+        } else {
+            orderRow(y, row, page, width);
+        }
+        // Each completed row of the display continues below the previous one
+        if (y % kRows_per_page == kRows_per_page - 1 || y + 1 == height) {
+            out_of_bounds =
+                mLcd.draw(page, width, false, width) || out_of_bounds;
+        }
+    }
+    mLcd.endTransfer();
+
+    return out_of_bounds;
+}
+
+void Nokia_LCD_Dither::orderRow(uint8_t y, const uint8_t row[],
+                                unsigned char page[], uint8_t width) {
+    const uint8_t *thresholds = kBayer_thresholds[y % kBayer_size];
+    const unsigned char bit = 1 << (y % kRows_per_page);
+    for (uint8_t x = 0; x < width; x++) {
+        if (row[x] < thresholds[x % kBayer_size]) {
+            page[x] |= bit;
+        }
+    }
+}
+
+void Nokia_LCD_Dither::diffuseRow(uint8_t y, const uint8_t row[],
+                                  unsigned char page[], uint8_t width) {
+    const unsigned char bit = 1 << (y % kRows_per_page);
+    // The error pushed to the right and the errors for the next row that are
+    // still being added up, as `mErrors` is read for this row at the same time
+    int16_t right = 0;
+    int16_t below = 0;
+    int16_t below_right = 0;
+    for (uint8_t x = 0; x < width; x++) {
+        const int16_t level = row[x] + mErrors[x] + right;
+        const bool black = level < kMid_gray;
+        if (black) {
+            page[x] |= bit;
+        }
+        const int16_t error = black ? level : level - kWhite;
+
+        right = error * 7 / 16;
+        if (x > 0) {
+            mErrors[x - 1] = below + error * 3 / 16;
+        }
+        below = below_right + error * 5 / 16;
+        below_right = error / 16;
+    }
+    mErrors[width - 1] = below;
+}
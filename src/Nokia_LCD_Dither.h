@@ -0,0 +1,96 @@
+/**
+ * Draws grayscale images, e.g. photos, gradients or heatmaps computed at
+ * runtime, on the monochrome display by dithering them.
+ *
+ * The image is read one row at a time and turned into the bytes of one
+ * 8 pixel tall row of the display at a time, which are then drawn at once.
+ * So, instead of a whole framebuffer, only a row of the image and a row of the
+ * display are kept, on the stack while an image is drawn, and a row of errors
+ * for error diffusion.
+ */
+#pragma once
+#include <stdint.h>
+
+#include "Nokia_LCD.h"
+
+class Nokia_LCD_Dither {
+public:
+    /**
+     * Fills in a row of the grayscale image
+     * @param y     The row, from the top of the image
+     * @param row   Where to write the row, 0 is black and 255 is white
+     * @param width The number of pixels in the row
+     */
+    using ReadGrayRowCallback = void (*)(uint8_t y, uint8_t row[],
+                                         uint8_t width);
+
+    /**
+     * Nokia_LCD_Dither constructor
+     * @param lcd The (initialized) display the images are drawn on
+     */
+    Nokia_LCD_Dither(Nokia_LCD &lcd);
+
+    /**
+     * Draws a grayscale image at the current cursor location using ordered
+     * (Bayer) dithering. Every pixel is compared to a threshold that depends
+     * only on its position, which gives a regular pattern and needs no state,
+     * so a part of the image can be redrawn on its own.
+     * @param  source A function that fills in each row of the image
+     * @param  width  The image width in pixels, up to 84
+     * @param  height The image height in pixels, up to 48
+     * @return        True if out of bounds error | False otherwise
+     */
+    bool drawOrdered(ReadGrayRowCallback source, uint8_t width,
+                     uint8_t height);
+
+    /**
+     * Draws a grayscale image at the current cursor location using
+     * Floyd-Steinberg error diffusion. The difference between each pixel and
+     * the shade it was drawn with is spread to the pixels next to it, which
+     * keeps more detail than ordered dithering.
+     * @param  source A function that fills in each row of the image
+     * @param  width  The image width in pixels, up to 84
+     * @param  height The image height in pixels, up to 48
+     * @return        True if out of bounds error | False otherwise
+     */
+    bool drawDiffused(ReadGrayRowCallback source, uint8_t width,
+                      uint8_t height);
+
+private:
+    /**
+     * Reads the image a row at a time, sets the pixels chosen by the dithering
+     * and draws every completed row of the display
+     * @param  source    A function that fills in each row of the image
+     * @param  width     The image width in pixels
+     * @param  height    The image height in pixels
+     * @param  diffusion Whether to use error diffusion instead of ordered
+     *                   dithering
+     * @return           True if out of bounds error | False otherwise
+     */
+    bool draw(ReadGrayRowCallback source, uint8_t width, uint8_t height,
+              bool diffusion);
+
+    /**
+     * Dithers a row of the image with error diffusion, leaving the errors for
+     * the next row in `mErrors`
+     * @param y     The row of the image
+     * @param row   The pixels of the row
+     * @param page  The row of the display the pixels are set in
+     * @param width The image width in pixels
+     */
+    void diffuseRow(uint8_t y, const uint8_t row[], unsigned char page[],
+                    uint8_t width);
+
+    /**
+     * Dithers a row of the image with a Bayer matrix
+     * @param y     The row of the image
+     * @param row   The pixels of the row
+     * @param page  The row of the display the pixels are set in
+     * @param width The image width in pixels
+     */
+    static void orderRow(uint8_t y, const uint8_t row[], unsigned char page[],
+                         uint8_t width);
+
+    Nokia_LCD &mLcd;
+    int16_t mErrors[nokia_lcd::kDisplay_max_width];
+};
@@ -0,0 +1,45 @@
+/**
+ * Reads data stored in flash memory with `PROGMEM`. Architectures whose flash
+ * is not read like RAM, e.g. AVR and ESP8266, provide `<avr/pgmspace.h>`, on
+ * the others the data is read as it is. The check does not depend on what was
+ * included before, so every file of the library reads flash the same way.
+ */
+#pragma once
+#include <stdint.h>
+#if __has_include(<avr/pgmspace.h>)
+#include <avr/pgmspace.h>
+#endif
+// If we are not building for AVR architectures ignore PROGMEM
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+
+namespace nokia_lcd {
+/**
+ * Reads a byte stored in flash memory
+ * @param  address The address of the byte
+ * @return         The byte
+ */
+inline unsigned char readFlashByte(const unsigned char *address) {
+#if __has_include(<avr/pgmspace.h>)
+    return pgm_read_byte_near(address);
+#else
+    return *address;
+#endif
+}
+
+inline char readFlashByte(const char *address) {
+    return readFlashByte(reinterpret_cast<const unsigned char *>(address));
+}
+
+/**
+ * Reads a 16-bit word stored in flash memory, little endian as on AVR
+ * @param  address The address of the word
+ * @return         The word
+ */
+inline uint16_t readFlashWord(const uint16_t *address) {
+    const unsigned char *bytes =
+        reinterpret_cast<const unsigned char *>(address);
+    return readFlashByte(bytes) | readFlashByte(bytes + 1) << 8;
+}
+}  // namespace nokia_lcd
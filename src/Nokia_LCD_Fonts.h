@@ -1,10 +1,5 @@
 #pragma once
-// If we are not building for AVR architectures ignore PROGMEM
-#if defined(__AVR__)
-#include <avr/pgmspace.h>
-#else
-#define PROGMEM
-#endif
+#include "LCD_Fonts.h"
 
 namespace Nokia_LCD_Fonts {
 const uint8_t kRows_per_character = 8;
@@ -212,4 +207,73 @@ const unsigned char kDefault_font[][kColumns_per_character] PROGMEM = {
     ,
     {0x78, 0x46, 0x41, 0x46, 0x78}  // 0x7f DEL
 };
+
+/* Extended font table:
+The glyphs of some code points beyond ASCII, laid out like the ones above,
+and the ranges of code points they belong to, sorted for a binary search.
+Missing code points are shown as a question mark. */
+const unsigned char kExtended_font[][kColumns_per_character] PROGMEM = {
+    {0x00, 0x06, 0x09, 0x09, 0x06}  // U+00B0 degree
+    ,
+    {0xfc, 0x40, 0x40, 0x20, 0x7c}  // U+00B5 micro
+    ,
+    {0x79, 0x14, 0x12, 0x14, 0x79}  // U+00C4 A umlaut
+    ,
+    {0x78, 0x16, 0x15, 0x16, 0x78}  // U+00C5 A ring
+    ,
+    {0x7e, 0x09, 0x7f, 0x49, 0x41}  // U+00C6 AE
+    ,
+    {0x39, 0x44, 0x44, 0x44, 0x39}  // U+00D6 O umlaut
+    ,
+    {0x5c, 0x32, 0x2a, 0x26, 0x1d}  // U+00D8 O slash
+    ,
+    {0x3d, 0x40, 0x40, 0x40, 0x3d}  // U+00DC U umlaut
+    ,
+    {0x7e, 0x01, 0x49, 0x4a, 0x34}  // U+00DF sharp s
+    ,
+    {0x20, 0x55, 0x54, 0x55, 0x78}  // U+00E4 a umlaut
+    ,
+    {0x20, 0x56, 0x55, 0x56, 0x78}  // U+00E5 a ring
+    ,
+    {0x24, 0x54, 0x78, 0x54, 0x58}  // U+00E6 ae
+    ,
+    {0x38, 0x54, 0x56, 0x55, 0x18}  // U+00E9 e acute
+    ,
+    {0x38, 0x45, 0x44, 0x45, 0x38}  // U+00F6 o umlaut
+    ,
+    {0x58, 0x64, 0x54, 0x4c, 0x34}  // U+00F8 o slash
+    ,
+    {0x3c, 0x41, 0x40, 0x21, 0x7c}  // U+00FC u umlaut
+    ,
+    {0x70, 0x4c, 0x43, 0x4c, 0x70}  // U+0394 Delta
+    ,
+    {0x5e, 0x61, 0x01, 0x61, 0x5e}  // U+03A9 Omega
+    ,
+    {0x38, 0x44, 0x44, 0x38, 0x44}  // U+03B1 alpha
+    ,
+    {0x04, 0x7c, 0x04, 0x7c, 0x04}  // U+03C0 pi
+    ,
+    {0x14, 0x3e, 0x55, 0x55, 0x41}  // U+20AC euro
+};
+const GlyphRange kExtended_ranges[] PROGMEM = {
+    {0x00b0, 0x00b0, 0},  // degree
+    {0x00b5, 0x00b5, 1},  // micro
+    {0x00c4, 0x00c6, 2},  // A umlaut to AE
+    {0x00d6, 0x00d6, 5},  // O umlaut
+    {0x00d8, 0x00d8, 6},  // O slash
+    {0x00dc, 0x00dc, 7},  // U umlaut
+    {0x00df, 0x00df, 8},  // sharp s
+    {0x00e4, 0x00e6, 9},  // a umlaut to ae
+    {0x00e9, 0x00e9, 12},  // e acute
+    {0x00f6, 0x00f6, 13},  // o umlaut
+    {0x00f8, 0x00f8, 14},  // o slash
+    {0x00fc, 0x00fc, 15},  // u umlaut
+    {0x0394, 0x0394, 16},  // Delta
+    {0x03a9, 0x03a9, 17},  // Omega
+    {0x03b1, 0x03b1, 18},  // alpha
+    {0x03bc, 0x03bc, 1},  // mu, same as micro
+    {0x03c0, 0x03c0, 19},  // pi
+    {0x20ac, 0x20ac, 20},  // euro
+};
+const uint16_t kFallback = '?';
 }  // namespace Nokia_LCD_Fonts
@@ -0,0 +1,278 @@
+#include <string.h>
+
+#include "Nokia_LCD_Framebuffer.h"
+#include "Nokia_LCD_Flash.h"
+
+namespace {
+const uint8_t kColumns = nokia_lcd::kDisplay_max_width;
+const uint8_t kPages = nokia_lcd::kDisplay_max_rows;
+const uint8_t kRows_per_page = 8;
+const uint8_t kClean = 0xFF;
+const uint8_t kAddress_bytes = 2;  // Column and row commands
+}  // namespace
+
+Nokia_LCD_Framebuffer::Nokia_LCD_Framebuffer(Nokia_LCD &lcd)
+    : mLcd{lcd},
+      mFront{nullptr},
+      mSending{false},
+      mX_cursor{0},
+      mY_cursor{0} {
+    memset(mBuffer, 0, sizeof(mBuffer));
+    // The display shows something else until everything is sent once
+    for (uint8_t page = 0; page < kPages; page++) {
+        mDirty_first[page] = 0;
+        mDirty_last[page] = kColumns - 1;
+        mPending_first[page] = kClean;
+        mPending_last[page] = kClean;
+    }
+}
+
+Nokia_LCD_Framebuffer::Nokia_LCD_Framebuffer(Nokia_LCD &lcd,
+                                             unsigned char front[])
+    : Nokia_LCD_Framebuffer(lcd) {
+    mFront = front;
+    memset(mFront, 0, nokia_lcd::kFramebuffer_size);
+    // The blank front buffer is sent with the first frame, whatever the first
+    // swap leaves of it
+    for (uint8_t page = 0; page < kPages; page++) {
+        mPending_first[page] = 0;
+        mPending_last[page] = kColumns - 1;
+    }
+}
+
+void Nokia_LCD_Framebuffer::clear(bool is_black) {
+    const unsigned char color = is_black ? 0xFF : 0x00;
+    for (uint8_t page = 0; page < kPages; page++) {
+        unsigned char *row = mBuffer + page * kColumns;
+        for (uint8_t x = 0; x < kColumns; x++) {
+            if (row[x] != color) {
+                row[x] = color;
+                markDirty(page, x, x);
+            }
+        }
+    }
+    mX_cursor = 0;
+    mY_cursor = 0;
+}
+
+bool Nokia_LCD_Framebuffer::setCursor(uint8_t x, uint8_t y) {
+    if (x >= kColumns || y >= kPages) {
+        return false;
+    }
+    mX_cursor = x;
+    mY_cursor = y;
+
+    return true;
+}
+
+bool Nokia_LCD_Framebuffer::setPixel(uint8_t x, uint8_t y, bool is_on) {
+    if (x >= kColumns || y >= nokia_lcd::kDisplay_max_height) {
+        return true;
+    }
+
+    const uint8_t page = y / kRows_per_page;
+    unsigned char &column = mBuffer[page * kColumns + x];
+    const unsigned char bit = 1 << (y % kRows_per_page);
+    const unsigned char updated = is_on ? column | bit : column & ~bit;
+    if (updated != column) {
+        column = updated;
+        markDirty(page, x, x);
+    }
+
+    return false;
+}
+
+bool Nokia_LCD_Framebuffer::getPixel(uint8_t x, uint8_t y) {
+    if (x >= kColumns || y >= nokia_lcd::kDisplay_max_height) {
+        return false;
+    }
+
+    return mBuffer[(y / kRows_per_page) * kColumns + x] &
+           (1 << (y % kRows_per_page));
+}
+
+bool Nokia_LCD_Framebuffer::draw(const unsigned char bitmap[],
+                                 const unsigned int bitmap_size,
+                                 const bool read_from_progmem,
+                                 const unsigned int bitmap_width) {
+    const uint8_t x_start = mX_cursor;
+    bool out_of_bounds = false;
+    for (unsigned int i = 0; i < bitmap_size; i++) {
+        put(read_from_progmem ? nokia_lcd::readFlashByte(bitmap + i) : bitmap[i]);
+        out_of_bounds = advance(x_start, bitmap_width) || out_of_bounds;
+    }
+
+    return out_of_bounds;
+}
+
+size_t Nokia_LCD_Framebuffer::write(uint8_t character) {
+    // Text written one byte at a time is decoded from UTF-8
+    const LcdFont *font = mLcd.getFont();
+    uint16_t code_point;
+    if (!font->decode(mDecoder, character, code_point)) {
+        return 1;
+    }
+    // Line endings written through `Print` are "\r\n", the new line suffices
+    if (code_point == '\r') {
+        return 1;
+    }
+    if (code_point == '\n') {
+        mX_cursor = 0;
+        mY_cursor = (mY_cursor + 1) % kPages;
+        return 1;
+    }
+
+    const LcdGlyph glyph = font->getExtendedGlyph(code_point);
+    const uint8_t x_start = mX_cursor;
+    for (uint8_t i = 0; i < glyph.width; i++) {
+        put(glyph.getColumn(i));
+        advance(x_start, nokia_lcd::kDisplay_max_width);
+    }
+    draw(font->hSpace, font->hSpaceSize, false);
+
+    return 1;
+}
+
+unsigned char *Nokia_LCD_Framebuffer::getBuffer() { return mBuffer; }
+
+void Nokia_LCD_Framebuffer::markDirty(uint8_t page, uint8_t first,
+                                      uint8_t last) {
+    if (page >= kPages || first > last) {
+        return;
+    }
+    if (last >= kColumns) {
+        last = kColumns - 1;
+    }
+    if (mDirty_first[page] == kClean) {
+        mDirty_first[page] = first;
+        mDirty_last[page] = last;
+        return;
+    }
+    if (first < mDirty_first[page]) {
+        mDirty_first[page] = first;
+    }
+    if (last > mDirty_last[page]) {
+        mDirty_last[page] = last;
+    }
+}
+
+bool Nokia_LCD_Framebuffer::swap() {
+    if (mFront == nullptr) {
+        return true;
+    }
+    // Replacing the rows of a frame that are still to be sent would show
+    // them next to rows of the previous frame
+    if (mSending) {
+        return false;
+    }
+
+    for (uint8_t page = 0; page < kPages; page++) {
+        if (mDirty_first[page] == kClean) {
+            continue;
+        }
+        // Narrow the changed span down to the bytes that really differ, e.g.
+        // not the ones that were drawn over with what was there before
+        const unsigned char *back = mBuffer + page * kColumns;
+        unsigned char *front = mFront + page * kColumns;
+        uint8_t first = mDirty_first[page];
+        uint8_t last = mDirty_last[page];
+        while (first <= last && back[first] == front[first]) {
+            first++;
+        }
+        while (last > first && back[last] == front[last]) {
+            last--;
+        }
+        mDirty_first[page] = kClean;
+        mDirty_last[page] = kClean;
+        if (first > last) {
+            continue;
+        }
+
+        memcpy(front + first, back + first, last - first + 1);
+        if (mPending_first[page] == kClean) {
+            mPending_first[page] = first;
+            mPending_last[page] = last;
+            continue;
+        }
+        if (first < mPending_first[page]) {
+            mPending_first[page] = first;
+        }
+        if (last > mPending_last[page]) {
+            mPending_last[page] = last;
+        }
+    }
+
+    return true;
+}
+
+unsigned int Nokia_LCD_Framebuffer::getPendingBytes() {
+    const uint8_t *firsts = mFront ? mPending_first : mDirty_first;
+    const uint8_t *lasts = mFront ? mPending_last : mDirty_last;
+    unsigned int pending = 0;
+    for (uint8_t page = 0; page < kPages; page++) {
+        if (firsts[page] != kClean) {
+            pending += lasts[page] - firsts[page] + 1 + kAddress_bytes;
+        }
+    }
+
+    return pending;
+}
+
+unsigned int Nokia_LCD_Framebuffer::flush(unsigned int max_bytes) {
+    // When double buffering, only the frames handed over are sent
+    const unsigned char *buffer = mFront ? mFront : mBuffer;
+    uint8_t *firsts = mFront ? mPending_first : mDirty_first;
+    uint8_t *lasts = mFront ? mPending_last : mDirty_last;
+    unsigned int sent = 0;
+    bool is_done = true;
+    mLcd.beginTransfer();
+    for (uint8_t page = 0; page < kPages; page++) {
+        if (firsts[page] == kClean) {
+            continue;
+        }
+        const uint8_t first = firsts[page];
+        const uint8_t length = lasts[page] - first + 1;
+        // Large updates are split across several flushes, a row at a time
+        if (sent > 0 && sent + length + kAddress_bytes > max_bytes) {
+            is_done = false;
+            break;
+        }
+
+        // Sent as they are, since `Nokia_LCD::setInverted()` is not meant
+        // to change what the pixels of the framebuffer are
+        mLcd.setCursor(first, page);
+        const unsigned char *row = buffer + page * kColumns;
+        for (uint8_t x = first; x <= lasts[page]; x++) {
+            mLcd.sendData(row[x]);
+        }
+        firsts[page] = kClean;
+        lasts[page] = kClean;
+        sent += length + kAddress_bytes;
+    }
+    mLcd.endTransfer();
+    mSending = !is_done;
+
+    return sent;
+}
+
+bool Nokia_LCD_Framebuffer::advance(uint8_t x_start, unsigned int width) {
+    mX_cursor++;
+    // Bitmaps wrap at their own left edge, anything else at the screen edge
+    const bool reached_margin = mX_cursor >= x_start + width;
+    if (reached_margin || mX_cursor >= kColumns) {
+        mX_cursor = reached_margin ? x_start : 0;
+        mY_cursor = (mY_cursor + 1) % kPages;
+        // If we are back to row 0 again, then we just went out of bounds
+        return mY_cursor == 0;
+    }
+
+    return false;
+}
+
+void Nokia_LCD_Framebuffer::put(unsigned char data) {
+    unsigned char &column = mBuffer[mY_cursor * kColumns + mX_cursor];
+    if (column != data) {
+        column = data;
+        markDirty(mY_cursor, mX_cursor, mX_cursor);
+    }
+}
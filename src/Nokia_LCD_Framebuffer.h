@@ -0,0 +1,171 @@
+/**
+ * Keeps a copy of the whole screen in RAM, so that drawing only changes the
+ * copy and the display is updated later, all at once.
+ *
+ * Since it needs 504 bytes, the framebuffer is meant for microcontrollers with
+ * enough RAM. In return, pixels can be set one by one and what is drawn can
+ * overlap, as nothing has to be drawn in whole 8 pixel tall columns. For every
+ * row of the display the framebuffer remembers the span of columns that
+ * changed, so only those are sent. The pixels are sent as they are, so
+ * `Nokia_LCD::setInverted()` does not invert them.
+ *
+ * The display has no vertical sync, so a frame that is sent while it is still
+ * being drawn shows up half finished. With a second buffer of 504 bytes, the
+ * framebuffer keeps the frame that is sent (the front buffer) apart from the
+ * one that is drawn (the back buffer). Only `swap()` hands a finished frame
+ * over, copying the bytes that differ to the front buffer. The frame can then
+ * be sent a few rows at a time, e.g. by a FrameScheduler with a time budget,
+ * while the next one is being drawn.
+ */
+#pragma once
+#include <stdint.h>
+
+#include "Nokia_LCD.h"
+
+namespace nokia_lcd {
+// Framebuffer constants
+const unsigned int kFramebuffer_size = kDisplay_max_width * kDisplay_max_rows;
+}  // namespace nokia_lcd
+
+class Nokia_LCD_Framebuffer : public Print {
+public:
+    /**
+     * Nokia_LCD_Framebuffer constructor
+     * @param lcd The (initialized) display the framebuffer is shown on
+     */
+    Nokia_LCD_Framebuffer(Nokia_LCD &lcd);
+
+    /**
+     * Nokia_LCD_Framebuffer constructor for double buffering. Everything is
+     * drawn on the back buffer and sent from the front buffer.
+     * @param lcd   The (initialized) display the framebuffer is shown on
+     * @param front The front buffer, `nokia_lcd::kFramebuffer_size` bytes
+     */
+    Nokia_LCD_Framebuffer(Nokia_LCD &lcd, unsigned char front[]);
+
+    /**
+     * Clears the framebuffer
+     * @param is_black The screen color after it is cleared. Default is white.
+     */
+    void clear(bool is_black = false);
+
+    /**
+     * Sets the location where the next character or bitmap is drawn
+     * @param  x Coordinates on the x-axis, can be between 0 and 83
+     * @param  y The row, can be between 0 and 5
+     * @return   True if the cursor was set | False if out of bounds
+     */
+    bool setCursor(uint8_t x, uint8_t y);
+
+    /**
+     * Turns a single pixel on or off
+     * @param  x     Coordinates on the x-axis, can be between 0 and 83
+     * @param  y     Coordinates on the y-axis, can be between 0 and 47
+     * @param  is_on Whether the pixel is black
+     * @return       True if out of bounds error | False otherwise
+     */
+    bool setPixel(uint8_t x, uint8_t y, bool is_on = true);
+
+    /**
+     * Returns whether a pixel is black
+     * @param  x Coordinates on the x-axis, can be between 0 and 83
+     * @param  y Coordinates on the y-axis, can be between 0 and 47
+     * @return   True if the pixel is black | False otherwise
+     */
+    bool getPixel(uint8_t x, uint8_t y);
+
+    /**
+     * Draws a bitmap at the cursor location, see `Nokia_LCD::draw()`
+     * @param  bitmap            The bitmap to be drawn
+     * @param  bitmap_size       The size of the bitmap
+     * @param  read_from_progmem Whether the bitmap is stored in flash memory
+     *                           instead of SRAM. Default read from flash.
+     * @param  bitmap_width      The bitmap width
+     * @return                   True if out of bounds error | False otherwise
+     */
+    bool draw(const unsigned char bitmap[], const unsigned int bitmap_size,
+              const bool read_from_progmem = true,
+              const unsigned int bitmap_width = nokia_lcd::kDisplay_max_width);
+
+    /**
+     * Draws a character with the font of the display at the cursor location.
+     * Everything that `Print` offers, e.g. `print(3.14)`, ends up here. Text
+     * is decoded from UTF-8, so a glyph may take several bytes.
+     * @param  character The character to be drawn
+     * @return           The number of characters drawn
+     */
+    size_t write(uint8_t character) override;
+    using Print::write;
+
+    /**
+     * Returns the framebuffer, laid out like the bitmaps of `draw()`. Call
+     * `markDirty()` for the parts that are changed through it.
+     * @return The framebuffer
+     */
+    unsigned char *getBuffer();
+
+    /**
+     * Marks a span of a row as changed, so that it is sent to the display
+     * @param page  The row, can be between 0 and 5
+     * @param first The first changed column
+     * @param last  The last changed column
+     */
+    void markDirty(uint8_t page, uint8_t first, uint8_t last);
+
+    /**
+     * Hands what was drawn over to be sent, when double buffering. The bytes
+     * that differ from the front buffer are copied to it. A frame that has not
+     * started to be sent is replaced, so frames may be dropped but are never
+     * shown mixed. Has no effect without a front buffer.
+     * @return True if the frame was handed over | False if the previous one
+     *         is partly sent, in which case drawing can go on until it is done
+     */
+    bool swap();
+
+    /**
+     * Returns how many bytes have changed and not been sent yet, including
+     * the commands to address each changed span. When double buffering,
+     * only the frames handed over by `swap()` count.
+     * @return The number of bytes
+     */
+    unsigned int getPendingBytes();
+
+    /**
+     * Sends the changed spans to the display, one row at a time. When double
+     * buffering, they are sent from the front buffer.
+     * @param  max_bytes Stops before the row that would exceed this many
+     *                   bytes, while the first changed row is always sent
+     * @return           The number of bytes sent, including the commands
+     */
+    unsigned int flush(unsigned int max_bytes = ~0U);
+
+private:
+    /**
+     * Moves the cursor to the next column, wrapping at the right margin
+     * @param  x_start The column where the next row starts
+     * @param  width   The width of what is being drawn
+     * @return         True if out of bounds error | False otherwise
+     */
+    bool advance(uint8_t x_start, unsigned int width);
+
+    /**
+     * Writes a byte at the cursor location
+     * @param data The byte
+     */
+    void put(unsigned char data);
+
+    Nokia_LCD &mLcd;
+    unsigned char mBuffer[nokia_lcd::kFramebuffer_size];
+    // The span of columns of each row that changed, empty if first > last
+    uint8_t mDirty_first[nokia_lcd::kDisplay_max_rows];
+    uint8_t mDirty_last[nokia_lcd::kDisplay_max_rows];
+    // When double buffering, the front buffer and the span of columns of
+    // each of its rows that has not been sent yet
+    unsigned char *mFront;
+    uint8_t mPending_first[nokia_lcd::kDisplay_max_rows];
+    uint8_t mPending_last[nokia_lcd::kDisplay_max_rows];
+    bool mSending;  // The front buffer has been partly sent
+    uint8_t mX_cursor;
+    uint8_t mY_cursor;
+    Utf8Decoder mDecoder;
+};
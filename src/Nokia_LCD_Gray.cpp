@@ -0,0 +1,152 @@
+#include "Nokia_LCD_Gray.h"
+
+#include <string.h>
+
+namespace {
+const uint8_t kRows_per_page = 8;
+const uint8_t kPages = nokia_lcd::kDisplay_max_height / kRows_per_page;
+const uint8_t kAll_pages = (1 << kPages) - 1;
+const uint8_t kBlack = nokia_lcd::kGray_levels - 1;
+const unsigned long kMicros_per_second = 1000000UL;
+}  // namespace
+
+Nokia_LCD_Gray::Nokia_LCD_Gray(Nokia_LCD &lcd)
+    : mLcd{lcd},
+      mPhase{0},
+      mDirty{kAll_pages},
+      mWith_light_gray{0},
+      mWith_dark_gray{0},
+      mInterval{0},
+      mPhase_start{0},
+      mCycle_start{0},
+      mCycle_micros{0} {
+    memset(mHigh, 0, sizeof(mHigh));
+    memset(mLow, 0, sizeof(mLow));
+}
+
+bool Nokia_LCD_Gray::setPixel(uint8_t x, uint8_t y, uint8_t level) {
+    if (x >= nokia_lcd::kDisplay_max_width ||
+        y >= nokia_lcd::kDisplay_max_height) {
+        return true;
+    }
+    if (level > kBlack) {
+        level = kBlack;
+    }
+
+    const uint8_t page = y / kRows_per_page;
+    const unsigned int index = page * nokia_lcd::kDisplay_max_width + x;
+    const unsigned char bit = 1 << (y % kRows_per_page);
+    const unsigned char high = (level & 0x02) ? mHigh[index] | bit
+                                              : mHigh[index] & ~bit;
+    const unsigned char low =
+        (level & 0x01) ? mLow[index] | bit : mLow[index] & ~bit;
+    if (high != mHigh[index] || low != mLow[index]) {
+        mHigh[index] = high;
+        mLow[index] = low;
+        mDirty |= 1 << page;
+    }
+
+    return false;
+}
+
+uint8_t Nokia_LCD_Gray::getPixel(uint8_t x, uint8_t y) {
+    if (x >= nokia_lcd::kDisplay_max_width ||
+        y >= nokia_lcd::kDisplay_max_height) {
+        return 0;
+    }
+
+    const unsigned int index =
+        (y / kRows_per_page) * nokia_lcd::kDisplay_max_width + x;
+    const uint8_t bit = y % kRows_per_page;
+
+    return ((mHigh[index] >> bit) & 1) << 1 | ((mLow[index] >> bit) & 1);
+}
+
+void Nokia_LCD_Gray::fill(uint8_t level) {
+    memset(mHigh, (level & 0x02) ? 0xFF : 0x00, sizeof(mHigh));
+    memset(mLow, (level & 0x01) ? 0xFF : 0x00, sizeof(mLow));
+    mDirty = kAll_pages;
+}
+
+void Nokia_LCD_Gray::setPhaseInterval(unsigned long interval) {
+    mInterval = interval;
+}
+
+bool Nokia_LCD_Gray::update() {
+    const unsigned long now = micros();
+    if (now - mPhase_start < mInterval) {
+        return false;
+    }
+    mPhase_start = now;
+
+    const uint8_t next = (mPhase + 1) % nokia_lcd::kGray_phases;
+    // Light gray pixels are only on in the first phase and dark gray ones are
+    // only off in the last one, so a row changes when entering or leaving them
+    uint8_t changing = mDirty;
+    for (uint8_t page = 0; page < kPages; page++) {
+        if (mDirty & (1 << page)) {
+            classify(page);
+        }
+    }
+    if (next == 1 || next == 0) {
+        changing |= mWith_light_gray;
+    }
+    if (next == 2 || next == 0) {
+        changing |= mWith_dark_gray;
+    }
+
+    mLcd.beginTransfer();
+    for (uint8_t page = 0; page < kPages; page++) {
+        if (!(changing & (1 << page))) {
+            continue;
+        }
+        mLcd.setCursor(0, page);
+        const unsigned int first = page * nokia_lcd::kDisplay_max_width;
+        for (uint8_t x = 0; x < nokia_lcd::kDisplay_max_width; x++) {
+            mLcd.sendData(phaseByte(first + x, next));
+        }
+    }
+    mLcd.endTransfer();
+    mDirty = 0;
+    mPhase = next;
+
+    if (mPhase == 0) {
+        mCycle_micros = now - mCycle_start;
+        mCycle_start = now;
+    }
+
+    return true;
+}
+
+uint16_t Nokia_LCD_Gray::getRefreshRate() {
+    return mCycle_micros == 0 ? 0 : kMicros_per_second / mCycle_micros;
+}
+
+unsigned long Nokia_LCD_Gray::getCycleMicros() { return mCycle_micros; }
+
+unsigned char Nokia_LCD_Gray::phaseByte(unsigned int index, uint8_t phase) {
+    switch (phase) {
+        case 0:
+            return mHigh[index] | mLow[index];
+        case 1:
+            return mHigh[index];
+        default:
+            return mHigh[index] & mLow[index];
+    }
+}
+
+void Nokia_LCD_Gray::classify(uint8_t page) {
+    unsigned char light_gray = 0;
+    unsigned char dark_gray = 0;
+    const unsigned int first = page * nokia_lcd::kDisplay_max_width;
+    for (uint8_t x = 0; x < nokia_lcd::kDisplay_max_width; x++) {
+        light_gray |= mLow[first + x] & ~mHigh[first + x];
+        dark_gray |= mHigh[first + x] & ~mLow[first + x];
+    }
+
+    const uint8_t bit = 1 << page;
+    mWith_light_gray = light_gray ? mWith_light_gray | bit
+                                  : mWith_light_gray & ~bit;
+    mWith_dark_gray =
+        dark_gray ? mWith_dark_gray | bit : mWith_dark_gray & ~bit;
+}
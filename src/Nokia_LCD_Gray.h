@@ -0,0 +1,122 @@
+/**
+ * Shows four levels of gray on the monochrome display, by quickly alternating
+ * between frames in which the darker pixels stay on for longer (frame rate
+ * control).
+ *
+ * The image is kept in two bitplanes, 1008 bytes in total, so it only suits
+ * microcontrollers with enough RAM. Every gray cycle is made of three phases:
+ * the first one shows all pixels that are not white, the second one shows the
+ * dark gray and black pixels and the third one only the black pixels. Only
+ * the rows of the display that look different from one phase to the next are
+ * sent again, so rows with just black and white cost nothing once drawn.
+ *
+ * The phases are not driven by a timer interrupt but by calling `update()`
+ * from `loop()`, since sending a phase takes the SPI bus for up to a whole
+ * screen and must not cut into other transfers. The gray cycle therefore runs
+ * only as fast and as evenly as `update()` is called: at least 60 times per
+ * second, i.e. no more than about 16 ms apart, keeps it above the roughly
+ * 20 Hz below which pixels flicker. Avoid `delay()` and other long blocking
+ * work in the loop, as unevenly spaced phases show as uneven gray levels, and
+ * use `setPhaseInterval()` to space them evenly when the loop is faster.
+ */
+#pragma once
+#include <stdint.h>
+
+#include "Nokia_LCD.h"
+
+namespace nokia_lcd {
+// Gray constants
+const uint8_t kGray_phases = 3;
+const uint8_t kGray_levels = 4;  // 0 is white, 3 is black
+const unsigned int kGray_plane_size =
+    kDisplay_max_width * (kDisplay_max_height / 8);
+}  // namespace nokia_lcd
+
+class Nokia_LCD_Gray {
+public:
+    /**
+     * Nokia_LCD_Gray constructor
+     * @param lcd The (initialized) display the image is shown on
+     */
+    Nokia_LCD_Gray(Nokia_LCD &lcd);
+
+    /**
+     * Sets the gray level of a pixel. It is shown as the phases go on.
+     * @param  x     Coordinates on the x-axis, can be between 0 and 83
+     * @param  y     Coordinates on the y-axis, can be between 0 and 47
+     * @param  level The gray level, from 0 (white) to 3 (black)
+     * @return       True if out of bounds error | False otherwise
+     */
+    bool setPixel(uint8_t x, uint8_t y, uint8_t level);
+
+    /**
+     * Returns the gray level of a pixel
+     * @param  x Coordinates on the x-axis, can be between 0 and 83
+     * @param  y Coordinates on the y-axis, can be between 0 and 47
+     * @return   The gray level, from 0 (white) to 3 (black)
+     */
+    uint8_t getPixel(uint8_t x, uint8_t y);
+
+    /**
+     * Sets all the pixels to the same gray level
+     * @param level The gray level, from 0 (white) to 3 (black)
+     */
+    void fill(uint8_t level = 0);
+
+    /**
+     * Sets the shortest time between two phases. Some displays show less
+     * flicker when the phases are a bit slower than the bus allows.
+     * @param interval The time in microseconds, 0 to go as fast as possible
+     */
+    void setPhaseInterval(unsigned long interval);
+
+    /**
+     * Sends the next phase, if it is time to. Has to be called as often as
+     * possible, at least 60 times per second, e.g. in every `loop()`, never
+     * from an interrupt.
+     * @return True if a phase was sent | False otherwise
+     */
+    bool update();
+
+    /**
+     * Returns how many complete gray cycles per second were shown. Below
+     * roughly 20 the pixels visibly flicker.
+     * @return The refresh rate in Hz, 0 until a cycle was completed
+     */
+    uint16_t getRefreshRate();
+
+    /**
+     * Returns how long the last complete gray cycle took
+     * @return The cycle time in microseconds
+     */
+    unsigned long getCycleMicros();
+
+private:
+    /**
+     * Returns the byte shown in a phase
+     * @param  index The byte in the bitplanes
+     * @param  phase The phase, from 0 to 2
+     * @return       The byte to be sent to the display
+     */
+    unsigned char phaseByte(unsigned int index, uint8_t phase);
+
+    /**
+     * Finds out which levels a row of the display contains, so that it is only
+     * sent in the phases in which it changes
+     * @param page The row of the display
+     */
+    void classify(uint8_t page);
+
+    Nokia_LCD &mLcd;
+    unsigned char mHigh[nokia_lcd::kGray_plane_size];
+    unsigned char mLow[nokia_lcd::kGray_plane_size];
+    uint8_t mPhase;
+    // A bit for each row of the display
+    uint8_t mDirty;
+    uint8_t mWith_light_gray;
+    uint8_t mWith_dark_gray;
+    unsigned long mInterval;
+    unsigned long mPhase_start;
+    unsigned long mCycle_start;
+    unsigned long mCycle_micros;
+};
@@ -0,0 +1,91 @@
+#include "Nokia_LCD_Group.h"
+
+DisplayGroup::DisplayGroup(Nokia_LCD &transport, const uint8_t ce_pins[],
+                           uint8_t count)
+    : mTransport{transport},
+      kCount{count < nokia_lcd::kMax_group_displays
+                 ? count
+                 : nokia_lcd::kMax_group_displays},
+      mSelected{kNo_display} {
+    for (uint8_t i = 0; i < kCount; i++) {
+        mCe_pins[i] = ce_pins[i];
+        mX_cursors[i] = 0;
+        mY_cursors[i] = 0;
+    }
+}
+
+void DisplayGroup::begin() {
+    for (uint8_t i = 0; i < kCount; i++) {
+        pinMode(mCe_pins[i], OUTPUT);
+    }
+    // From now on the group decides who listens, not the transport
+    mTransport.couple();
+    // The reset pin is shared, so all displays are initialized at once
+    select(kAll_displays);
+    mTransport.begin();
+    select(kNo_display);
+
+    for (uint8_t i = 0; i < kCount; i++) {
+        mX_cursors[i] = 0;
+        mY_cursors[i] = 0;
+    }
+}
+
+uint8_t DisplayGroup::size() { return kCount; }
+
+bool DisplayGroup::beginDisplay(uint8_t display) {
+    if (display >= kCount) {
+        // Whatever is drawn until `end()` reaches none of the displays
+        select(kNo_display);
+        return true;
+    }
+    select(display);
+    mTransport.beginTransfer();
+    // Only address the display if its cursor is not where the transport
+    // thinks it is, e.g. after a broadcast
+    if (mTransport.getCursorX() != mX_cursors[display] ||
+        mTransport.getCursorY() != mY_cursors[display]) {
+        mTransport.setCursor(mX_cursors[display], mY_cursors[display]);
+    }
+
+    return false;
+}
+
+Nokia_LCD &DisplayGroup::beginBroadcast() {
+    select(kAll_displays);
+    mTransport.beginTransfer();
+
+    return mTransport;
+}
+
+void DisplayGroup::end() {
+    mTransport.endTransfer();
+    for (uint8_t i = 0; i < kCount; i++) {
+        if (mSelected == kAll_displays || mSelected == i) {
+            mX_cursors[i] = mTransport.getCursorX();
+            mY_cursors[i] = mTransport.getCursorY();
+        }
+    }
+    select(kNo_display);
+}
+
+void DisplayGroup::clear(bool is_black) {
+    beginBroadcast().clear(is_black);
+    end();
+}
+
+void DisplayGroup::setContrast(uint8_t contrast) {
+    beginBroadcast().setContrast(contrast);
+    end();
+}
+
+void DisplayGroup::select(uint8_t display) {
+    if (display == mSelected) {
+        return;
+    }
+    for (uint8_t i = 0; i < kCount; i++) {
+        const bool listens = display == kAll_displays || display == i;
+        digitalWrite(mCe_pins[i], listens ? LOW : HIGH);
+    }
+    mSelected = display;
+}
@@ -0,0 +1,100 @@
+/**
+ * Drives several displays that share the clock, data, data/command and reset
+ * pins, each one with its own chip select (CE) pin.
+ *
+ * All the bytes go through a single Nokia_LCD, the "transport", while the
+ * group decides which displays listen to them. Different content is drawn on
+ * each display by selecting it alone, while content that is the same for all
+ * of them (e.g. a header or clearing the screen) is sent once to all of them
+ * at the same time.
+ */
+#pragma once
+#include <stdint.h>
+
+#include "Nokia_LCD.h"
+
+namespace nokia_lcd {
+// Group constants
+const uint8_t kMax_group_displays = 8;
+}  // namespace nokia_lcd
+
+class DisplayGroup {
+public:
+    /**
+     * DisplayGroup constructor
+     * @param transport A Nokia_LCD created with the shared pins and the CE pin
+     *                  of any display of the group
+     * @param ce_pins   The chip select pins of the displays
+     * @param count     The number of displays, up to
+     *                  `nokia_lcd::kMax_group_displays`
+     */
+    DisplayGroup(Nokia_LCD &transport, const uint8_t ce_pins[],
+                 uint8_t count);
+
+    /**
+     * Resets and initializes all the displays at once. Has to be called
+     * before usage instead of `Nokia_LCD::begin()`.
+     */
+    void begin();
+
+    /**
+     * Returns the number of displays in the group
+     * @return The number of displays
+     */
+    uint8_t size();
+
+    /**
+     * Selects a single display and starts a transfer, so that everything
+     * printed or drawn until `end()` is sent to it without any further bus
+     * overhead. The cursor is where it was left on that display. Draw on it
+     * with the transport.
+     * @example `if (!group.beginDisplay(2)) { lcd.print("Hi"); } group.end();`
+     * @param  display The index of the display
+     * @return         True if out of bounds error, when there is no such
+     *                 display and none is selected | False otherwise
+     */
+    bool beginDisplay(uint8_t display);
+
+    /**
+     * Selects all the displays and starts a transfer, so that everything until
+     * `end()` is sent to all of them at once. Afterwards, the cursor of every
+     * display is where the broadcast left it.
+     * @return The transport to draw on all the displays with
+     */
+    Nokia_LCD &beginBroadcast();
+
+    /**
+     * Ends the transfer started with `beginDisplay()` or `beginBroadcast()`
+     * and deselects the displays.
+     */
+    void end();
+
+    /**
+     * Clears all the displays at once, see `Nokia_LCD::clear()`.
+     * @param is_black The screen color after it is cleared. Default is white.
+     */
+    void clear(bool is_black = false);
+
+    /**
+     * Sets the contrast of all the displays at once.
+     * @param contrast Contrast value between 40 and 60 is usually good
+     */
+    void setContrast(uint8_t contrast);
+
+private:
+    /**
+     * Drives the chip select pins so that only the specified displays listen.
+     * @param display The index of the display or `kAll_displays`
+     */
+    void select(uint8_t display);
+
+    static const uint8_t kAll_displays = 0xFF;
+    static const uint8_t kNo_display = 0xFE;
+
+    Nokia_LCD &mTransport;
+    uint8_t mCe_pins[nokia_lcd::kMax_group_displays];
+    uint8_t mX_cursors[nokia_lcd::kMax_group_displays];
+    uint8_t mY_cursors[nokia_lcd::kMax_group_displays];
+    const uint8_t kCount;
+    uint8_t mSelected;
+};
@@ -0,0 +1,105 @@
+#include "Nokia_LCD_Queue.h"
+
+namespace {
+const uint8_t kIndex_mask = nokia_lcd::kQueue_capacity - 1;
+
+// Reading an index acquires the slots it publishes and writing one releases
+// them. Single byte accesses are atomic on AVR, so it is enough to stop the
+// compiler from reordering, while other architectures also need fences.
+inline uint8_t acquire(const volatile uint8_t &index) {
+#if defined(__AVR__)
+    const uint8_t value = index;
+    asm volatile("" ::: "memory");
+    return value;
+#else
+    return __atomic_load_n(&index, __ATOMIC_ACQUIRE);
+#endif
+}
+
+inline void release(volatile uint8_t &index, const uint8_t value) {
+#if defined(__AVR__)
+    asm volatile("" ::: "memory");
+    index = value;
+#else
+    __atomic_store_n(&index, value, __ATOMIC_RELEASE);
+#endif
+}
+}  // namespace
+
+Nokia_LCD_Queue::Nokia_LCD_Queue(Nokia_LCD &lcd)
+    : mLcd{lcd}, mHead{0}, mTail{0} {}
+
+bool Nokia_LCD_Queue::setCursor(uint8_t x, uint8_t y) {
+    return post({nokia_lcd::DrawOperation::kSet_cursor, x, y, nullptr});
+}
+
+bool Nokia_LCD_Queue::print(char character) {
+    return post({nokia_lcd::DrawOperation::kGlyph,
+                 static_cast<uint8_t>(character), 0, nullptr});
+}
+
+bool Nokia_LCD_Queue::draw(const unsigned char bitmap[], uint8_t bitmap_size,
+                           uint8_t width) {
+    return post(
+        {nokia_lcd::DrawOperation::kIcon, bitmap_size, width, bitmap});
+}
+
+bool Nokia_LCD_Queue::fill(uint8_t pattern, uint8_t count) {
+    return post({nokia_lcd::DrawOperation::kFill, pattern, count, nullptr});
+}
+
+bool Nokia_LCD_Queue::post(const nokia_lcd::DrawOperation &operation) {
+    const uint8_t head = mHead;
+    if (static_cast<uint8_t>(head - acquire(mTail)) ==
+        nokia_lcd::kQueue_capacity) {
+        return false;
+    }
+
+    mOperations[head & kIndex_mask] = operation;
+    release(mHead, head + 1);
+
+    return true;
+}
+
+uint8_t Nokia_LCD_Queue::service() {
+    uint8_t serviced = 0;
+    uint8_t tail = mTail;
+    if (tail == acquire(mHead)) {
+        return serviced;
+    }
+
+    mLcd.beginTransfer();
+    // Operations posted while servicing are sent in the same transfer, as
+    // long as a busy producer cannot keep us here forever
+    while (tail != acquire(mHead) && serviced < nokia_lcd::kQueue_capacity) {
+        const nokia_lcd::DrawOperation operation =
+            mOperations[tail & kIndex_mask];
+        release(mTail, ++tail);
+
+        execute(operation);
+        serviced++;
+    }
+    mLcd.endTransfer();
+
+    return serviced;
+}
+
+void Nokia_LCD_Queue::execute(const nokia_lcd::DrawOperation &operation) {
+    switch (operation.type) {
+        case nokia_lcd::DrawOperation::kSet_cursor:
+            mLcd.setCursor(operation.first, operation.second);
+            break;
+        case nokia_lcd::DrawOperation::kGlyph:
+            mLcd.print(static_cast<char>(operation.first));
+            break;
+        case nokia_lcd::DrawOperation::kIcon:
+            mLcd.draw(operation.bitmap, operation.first, true,
+                      operation.second);
+            break;
+        case nokia_lcd::DrawOperation::kFill:
+            for (uint8_t i = 0; i < operation.second; i++) {
+                mLcd.sendData(operation.first);
+            }
+            break;
+    }
+}
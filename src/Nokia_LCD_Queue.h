@@ -0,0 +1,109 @@
+/**
+ * A queue of drawing operations for a Nokia_LCD, that may be filled from an
+ * interrupt service routine (or another task) and is emptied in the main loop.
+ *
+ * The queue is lock-free for a single producer and a single consumer: the
+ * producer only ever moves the head, the consumer only ever moves the tail,
+ * and both indices are a single byte so they are read and written at once.
+ * Nothing is sent to the display until `service()` is called, which sends all
+ * the pending operations within a single bus transfer.
+ */
+#pragma once
+#include <stdint.h>
+
+#include "Nokia_LCD.h"
+
+namespace nokia_lcd {
+// Queue constants
+const uint8_t kQueue_capacity = 16;  // Must be a power of two
+static_assert((kQueue_capacity & (kQueue_capacity - 1)) == 0,
+              "The queue capacity must be a power of two");
+
+// A compact drawing operation
+struct DrawOperation {
+    enum Type : uint8_t { kSet_cursor, kGlyph, kIcon, kFill };
+
+    Type type;
+    uint8_t first;                // x, character, icon size or fill pattern
+    uint8_t second;               // y, icon width or fill count
+    const unsigned char *bitmap;  // Icon stored in flash memory
+};
+}  // namespace nokia_lcd
+
+class Nokia_LCD_Queue {
+public:
+    /**
+     * Nokia_LCD_Queue constructor
+     * @param lcd The (initialized) display the operations are drawn on
+     */
+    Nokia_LCD_Queue(Nokia_LCD &lcd);
+
+    /**
+     * Queues moving the cursor, see `Nokia_LCD::setCursor()`. Safe to call
+     * from an interrupt.
+     * @param  x Coordinates on the x-axis, can be between 0 and 83
+     * @param  y Coordinates on the y-axis, can be between 0 and 5
+     * @return   True if the operation was queued | False if the queue is full
+     */
+    bool setCursor(uint8_t x, uint8_t y);
+
+    /**
+     * Queues printing a character with the current font. Safe to call from an
+     * interrupt.
+     * @param  character The character to be printed
+     * @return           True if the operation was queued | False if the queue
+     *                   is full
+     */
+    bool print(char character);
+
+    /**
+     * Queues drawing a bitmap stored in flash memory, see `Nokia_LCD::draw()`.
+     * Safe to call from an interrupt.
+     * @param  bitmap      The bitmap to be displayed
+     * @param  bitmap_size The size of the bitmap, up to 255 bytes
+     * @param  width       The bitmap width
+     * @return             True if the operation was queued | False if the
+     *                     queue is full
+     */
+    bool draw(const unsigned char bitmap[], uint8_t bitmap_size,
+              uint8_t width = nokia_lcd::kDisplay_max_width);
+
+    /**
+     * Queues sending the same byte several times, e.g. to clear part of a row.
+     * Safe to call from an interrupt.
+     * @param  pattern The byte to be sent
+     * @param  count   How many times to send it
+     * @return         True if the operation was queued | False if the queue
+     *                 is full
+     */
+    bool fill(uint8_t pattern, uint8_t count);
+
+    /**
+     * Queues any drawing operation. Safe to call from an interrupt.
+     * @param  operation The operation to be queued
+     * @return           True if the operation was queued | False if the queue
+     *                   is full
+     */
+    bool post(const nokia_lcd::DrawOperation &operation);
+
+    /**
+     * Sends all the queued operations to the display in a single transfer.
+     * Must be called from the main loop, never from an interrupt.
+     * @return The number of operations that were sent
+     */
+    uint8_t service();
+
+private:
+    /**
+     * Sends a single operation to the display.
+     * @param operation The operation to be sent
+     */
+    void execute(const nokia_lcd::DrawOperation &operation);
+
+    Nokia_LCD &mLcd;
+    nokia_lcd::DrawOperation mOperations[nokia_lcd::kQueue_capacity];
+    // Free running indices, only the producer writes the head and only the
+    // consumer writes the tail
+    volatile uint8_t mHead;
+    volatile uint8_t mTail;
+};
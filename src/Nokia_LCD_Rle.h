@@ -0,0 +1,67 @@
+/**
+ * Reads bitmaps that were compressed with run-length encoding (RLE), e.g. by
+ * `extras/nokia_lcd_convert.py --rle`, while they are being drawn.
+ *
+ * The compressed bitmap is a sequence of runs, each one starting with a
+ * control byte. A control byte below 128 is followed by that many plus one
+ * bytes which are copied as they are. Any other control byte is followed by a
+ * single byte which is repeated control byte minus 126 times (2 to 129).
+ * Since blank areas compress well, most bitmaps shrink considerably.
+ */
+#pragma once
+#include <stdint.h>
+
+#include "Nokia_LCD.h"
+#include "Nokia_LCD_Flash.h"
+
+class RleIterator {
+public:
+    /**
+     * RleIterator constructor
+     * @example `lcd.drawStream(RleIterator(kLogo), RleIterator(kLogo +
+     *          sizeof(kLogo)), kLogo_width);`
+     * @param position The beginning of a compressed bitmap stored in flash
+     *                 memory or, for the iterator marking its end, right after
+     *                 it
+     */
+    explicit RleIterator(const unsigned char *position)
+        : mPosition{position}, mRemaining{0}, mLiteral{false}, mValue{0} {}
+
+    unsigned char operator*() {
+        if (mRemaining == 0) {
+            startRun();
+        }
+        return mValue;
+    }
+
+    RleIterator &operator++() {
+        if (mRemaining == 0) {
+            startRun();
+        }
+        if (--mRemaining > 0 && mLiteral) {
+            mValue = read(mPosition++);
+        }
+        return *this;
+    }
+
+    bool operator!=(const RleIterator &other) const {
+        return mRemaining > 0 || mPosition != other.mPosition;
+    }
+
+private:
+    void startRun() {
+        const uint8_t control = read(mPosition++);
+        mLiteral = control < 128;
+        mRemaining = mLiteral ? control + 1 : control - 126;
+        mValue = read(mPosition++);
+    }
+
+    static unsigned char read(const unsigned char *position) {
+        return nokia_lcd::readFlashByte(position);
+    }
+
+    const unsigned char *mPosition;
+    uint8_t mRemaining;
+    bool mLiteral;
+    unsigned char mValue;
+};
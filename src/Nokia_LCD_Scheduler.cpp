@@ -0,0 +1,69 @@
+#include "Nokia_LCD_Scheduler.h"
+
+namespace {
+const unsigned long kMicros_per_second = 1000000UL;
+}  // namespace
+
+FrameScheduler::FrameScheduler(Nokia_LCD_Framebuffer &framebuffer,
+                               uint8_t max_rate, unsigned long budget_micros)
+    : mFramebuffer{framebuffer},
+      mFrame_interval{0},
+      mBudget{budget_micros},
+      mByte_micros{nokia_lcd::kDefault_byte_micros},
+      mLast_frame{0},
+      mStarted{false},
+      mFrame_micros{0},
+      mDeferred{0},
+      mWindow_start{0},
+      mWindow_frames{0},
+      mFps{0} {
+    setMaxRate(max_rate);
+}
+
+void FrameScheduler::setMaxRate(uint8_t max_rate) {
+    mFrame_interval = max_rate == 0 ? 0 : kMicros_per_second / max_rate;
+}
+
+void FrameScheduler::setBudget(unsigned long budget_micros) {
+    mBudget = budget_micros;
+}
+
+bool FrameScheduler::update() {
+    const unsigned long start = micros();
+    if (start - mWindow_start >= kMicros_per_second) {
+        mFps = mWindow_frames;
+        mWindow_frames = 0;
+        mWindow_start = start;
+    }
+    if ((mStarted && start - mLast_frame < mFrame_interval) ||
+        mFramebuffer.getPendingBytes() == 0) {
+        return false;
+    }
+    mLast_frame = start;
+    mStarted = true;
+
+    const unsigned long budget_bytes =
+        mBudget == 0 ? ~0U : mBudget / mByte_micros;
+    const unsigned int sent = mFramebuffer.flush(
+        budget_bytes < ~0U ? static_cast<unsigned int>(budget_bytes) : ~0U);
+    mFrame_micros = micros() - start;
+    mDeferred = mFramebuffer.getPendingBytes();
+    mWindow_frames++;
+
+    // Follow changes of the bus speed, without jumping at every frame
+    if (sent > 0) {
+        const unsigned long measured = mFrame_micros / sent;
+        // Rounded up, so that it never reaches zero
+        mByte_micros = (3UL * mByte_micros + measured + 3) / 4;
+    }
+
+    return true;
+}
+
+uint8_t FrameScheduler::getFps() { return mFps; }
+
+unsigned long FrameScheduler::getFrameMicros() { return mFrame_micros; }
+
+unsigned int FrameScheduler::getDeferredBytes() { return mDeferred; }
+
+unsigned int FrameScheduler::getByteMicros() { return mByte_micros; }
@@ -0,0 +1,93 @@
+/**
+ * Sends what was drawn on a Nokia_LCD_Framebuffer in frames, instead of every
+ * time something changes.
+ *
+ * Everything drawn between two frames is sent together, at most as often as
+ * the maximum frame rate allows, which avoids showing half finished updates
+ * and wasting bus time on values that change faster than anyone can read.
+ * Each frame can also be kept within a time budget, so that the rest of the
+ * loop is not held up for long: large updates are then spread over several
+ * frames, a row of the display at a time.
+ */
+#pragma once
+#include <stdint.h>
+
+#include "Nokia_LCD_Framebuffer.h"
+
+namespace nokia_lcd {
+// Scheduler constants
+const uint8_t kDefault_frame_rate = 30;
+const unsigned int kDefault_byte_micros = 20;  // Until it is measured
+}  // namespace nokia_lcd
+
+class FrameScheduler {
+public:
+    /**
+     * FrameScheduler constructor
+     * @param framebuffer   The framebuffer to be sent
+     * @param max_rate      The most frames per second
+     * @param budget_micros How long a frame may take in microseconds, 0 for
+     *                      no limit
+     */
+    FrameScheduler(Nokia_LCD_Framebuffer &framebuffer,
+                   uint8_t max_rate = nokia_lcd::kDefault_frame_rate,
+                   unsigned long budget_micros = 0);
+
+    /**
+     * Sets the most frames per second
+     * @param max_rate The frame rate, 0 for as fast as possible
+     */
+    void setMaxRate(uint8_t max_rate);
+
+    /**
+     * Sets how long a frame may take. The time it takes to send a byte is
+     * measured as frames are sent, so the budget adapts to the bus speed.
+     * @param budget_micros The time in microseconds, 0 for no limit
+     */
+    void setBudget(unsigned long budget_micros);
+
+    /**
+     * Sends a frame, if it is time to and something has changed. Has to be
+     * called as often as possible, e.g. in every `loop()`.
+     * @return True if a frame was sent | False otherwise
+     */
+    bool update();
+
+    /**
+     * Returns how many frames were sent during the last second
+     * @return The frame rate
+     */
+    uint8_t getFps();
+
+    /**
+     * Returns how long the last frame took to send
+     * @return The time in microseconds
+     */
+    unsigned long getFrameMicros();
+
+    /**
+     * Returns how many bytes the last frame left for the next ones, because
+     * they did not fit in its budget
+     * @return The number of bytes
+     */
+    unsigned int getDeferredBytes();
+
+    /**
+     * Returns how long sending a byte takes, as measured
+     * @return The time in microseconds
+     */
+    unsigned int getByteMicros();
+
+private:
+    Nokia_LCD_Framebuffer &mFramebuffer;
+    unsigned long mFrame_interval;
+    unsigned long mBudget;
+    unsigned int mByte_micros;
+    unsigned long mLast_frame;
+    bool mStarted;
+    unsigned long mFrame_micros;
+    unsigned int mDeferred;
+    unsigned long mWindow_start;
+    uint8_t mWindow_frames;
+    uint8_t mFps;
+};
@@ -0,0 +1,426 @@
+#include <string.h>
+
+#include "Nokia_LCD_Widgets.h"
+#include "Nokia_LCD_Flash.h"
+
+namespace {
+const uint8_t kColumns = nokia_lcd::kDisplay_max_width;
+const uint8_t kPages = nokia_lcd::kDisplay_max_rows;
+const uint8_t kRows_per_page = 8;
+const uint8_t kLine_height = 8;
+const uint8_t kClean = 0xFF;
+
+/**
+ * Returns the rows of a page covered by a vertical range of pixels
+ * @param  page   The page
+ * @param  top    The first pixel of the range
+ * @param  bottom The last pixel of the range
+ * @return        A bit for each covered row, the top one is the lowest bit
+ */
+unsigned char rowMask(uint8_t page, unsigned int top, unsigned int bottom) {
+    const unsigned int page_top = page * kRows_per_page;
+    const unsigned int page_bottom = page_top + kRows_per_page - 1;
+    if (top > page_bottom || bottom < page_top) {
+        return 0;
+    }
+    const uint8_t first = top > page_top ? top - page_top : 0;
+    const uint8_t last =
+        bottom < page_bottom ? bottom - page_top : kRows_per_page - 1;
+
+    return (0xFF << first) & (0xFF >> (kRows_per_page - 1 - last));
+}
+}  // namespace
+
+WidgetCanvas::WidgetCanvas(unsigned char columns[], const LcdFont *font)
+    : mColumns{columns},
+      mFont{font},
+      mPage{0},
+      mLeft{0},
+      mRight{0},
+      mMask{0} {}
+
+void WidgetCanvas::fill(const nokia_lcd::Rect &area, bool is_black) {
+    if (area.width == 0 || area.height == 0) {
+        return;
+    }
+    const unsigned char mask =
+        rowMask(mPage, area.y, area.y + area.height - 1) & mMask;
+    const unsigned int right = area.x + area.width - 1;
+    const uint8_t first = area.x > mLeft ? area.x : mLeft;
+    const uint8_t last = right < mRight ? right : mRight;
+    for (unsigned int x = first; x <= last; x++) {
+        mColumns[x] = is_black ? mColumns[x] | mask : mColumns[x] & ~mask;
+    }
+}
+
+void WidgetCanvas::put(uint8_t x, uint8_t y, unsigned char column,
+                       bool is_black) {
+    if (x < mLeft || x > mRight) {
+        return;
+    }
+    const int offset = y - mPage * kRows_per_page;
+    if (offset <= -kRows_per_page || offset >= kRows_per_page) {
+        return;
+    }
+    const unsigned char pixels =
+        (offset >= 0 ? column << offset : column >> -offset) & mMask;
+    mColumns[x] = is_black ? mColumns[x] | pixels : mColumns[x] & ~pixels;
+}
+
+unsigned int WidgetCanvas::print(unsigned int x, uint8_t y,
+                                 const char *string, bool is_black) {
+    Utf8Decoder decoder;
+    uint16_t code_point;
+    for (; *string != '\0' && x <= mRight; string++) {
+        if (!mFont->decode(decoder, *string, code_point)) {
+            continue;
+        }
+        const LcdGlyph glyph = mFont->getExtendedGlyph(code_point);
+        // Glyphs left of the canvas are skipped without unpacking them
+        if (x + glyph.width > mLeft) {
+            for (uint8_t i = 0; i < glyph.width; i++) {
+                put(x + i, y, glyph.getColumn(i), is_black);
+            }
+        }
+        x += glyph.width + mFont->hSpaceSize;
+    }
+
+    return x;
+}
+
+unsigned int WidgetCanvas::measure(const char *string) {
+    unsigned int width = 0;
+    Utf8Decoder decoder;
+    uint16_t code_point;
+    for (; *string != '\0'; string++) {
+        if (mFont->decode(decoder, *string, code_point)) {
+            width += mFont->getExtendedWidth(code_point) + mFont->hSpaceSize;
+        }
+    }
+
+    return width == 0 ? 0 : width - mFont->hSpaceSize;
+}
+
+Widget::Widget(const nokia_lcd::Rect &bounds)
+    : mBounds(bounds),
+      mVisible{true},
+      mZ{0},
+      mScreen{nullptr},
+      mNext{nullptr} {}
+
+const nokia_lcd::Rect &Widget::getBounds() { return mBounds; }
+
+void Widget::setVisible(bool visible) {
+    if (visible != mVisible) {
+        mVisible = visible;
+        damage();
+    }
+}
+
+bool Widget::isVisible() { return mVisible; }
+
+void Widget::damage() { damage(mBounds); }
+
+void Widget::damage(const nokia_lcd::Rect &area) {
+    if (mScreen != nullptr) {
+        mScreen->damage(area);
+    }
+}
+
+Label::Label(const nokia_lcd::Rect &bounds, const char *string,
+             nokia_lcd::Alignment alignment)
+    : Widget(bounds), mText{string}, kAlignment{alignment} {}
+
+void Label::setText(const char *string) {
+    mText = string;
+    damage();
+}
+
+void Label::render(WidgetCanvas &canvas) {
+    const unsigned int width = canvas.measure(mText);
+    unsigned int x = mBounds.x;
+    if (width < mBounds.width && kAlignment != nokia_lcd::Alignment::kLeft) {
+        const uint8_t space = mBounds.width - width;
+        x += kAlignment == nokia_lcd::Alignment::kCenter ? space / 2 : space;
+    }
+    canvas.print(x, mBounds.y, mText);
+}
+
+NumberLabel::NumberLabel(const nokia_lcd::Rect &bounds, uint8_t decimals,
+                         nokia_lcd::Alignment alignment)
+    : Label(bounds, mNumber, alignment),
+      kDecimals{decimals < nokia_lcd::kMax_number_decimals
+                    ? decimals
+                    : nokia_lcd::kMax_number_decimals},
+      mNumber{} {
+    setValue(0);
+}
+
+void NumberLabel::setValue(long value) {
+    // Written backwards, starting from the last digit
+    char number[nokia_lcd::kMax_number_text];
+    uint8_t position = sizeof(number) - 1;
+    number[position] = '\0';
+    // Negating in unsigned arithmetic keeps the most negative value right
+    unsigned long magnitude = value < 0 ? 0UL - value : value;
+    uint8_t digits = 0;
+    do {
+        number[--position] = '0' + magnitude % 10;
+        magnitude /= 10;
+        if (++digits == kDecimals) {
+            number[--position] = '.';
+        }
+        // The integer part has at least one digit
+    } while (magnitude > 0 || digits <= kDecimals);
+    if (value < 0) {
+        number[--position] = '-';
+    }
+
+    if (strcmp(mNumber, number + position) != 0) {
+        strcpy(mNumber, number + position);
+        damage();
+    }
+}
+
+Icon::Icon(const nokia_lcd::Rect &bounds, const unsigned char bitmap[],
+           bool read_from_progmem)
+    : Widget(bounds), mBitmap{bitmap}, kRead_from_progmem{read_from_progmem} {}
+
+void Icon::setBitmap(const unsigned char bitmap[]) {
+    mBitmap = bitmap;
+    damage();
+}
+
+void Icon::render(WidgetCanvas &canvas) {
+    const uint8_t pages = (mBounds.height + kRows_per_page - 1) / kRows_per_page;
+    for (uint8_t page = 0; page < pages; page++) {
+        const unsigned char *row = mBitmap + page * mBounds.width;
+        const uint8_t y = mBounds.y + page * kRows_per_page;
+        for (uint8_t x = 0; x < mBounds.width; x++) {
+            canvas.put(mBounds.x + x, y,
+                       kRead_from_progmem ? nokia_lcd::readFlashByte(row + x)
+                                          : row[x]);
+        }
+    }
+}
+
+ProgressBar::ProgressBar(const nokia_lcd::Rect &bounds, uint16_t max)
+    : Widget(bounds), kMax{max}, mValue{0} {}
+
+void ProgressBar::setValue(uint16_t value) {
+    if (value > kMax) {
+        value = kMax;
+    }
+    const uint8_t before = filled(mValue);
+    const uint8_t after = filled(value);
+    mValue = value;
+    if (before == after) {
+        return;
+    }
+
+    // Only the columns between the old and the new end of the bar change
+    const uint8_t first = before < after ? before : after;
+    const uint8_t count = before < after ? after - first : before - first;
+    damage({static_cast<uint8_t>(mBounds.x + 1 + first), mBounds.y, count,
+            mBounds.height});
+}
+
+void ProgressBar::render(WidgetCanvas &canvas) {
+    if (mBounds.width < 2 || mBounds.height < 2) {
+        return;
+    }
+    canvas.fill(mBounds);
+    const nokia_lcd::Rect inside{
+        static_cast<uint8_t>(mBounds.x + 1), static_cast<uint8_t>(mBounds.y + 1),
+        static_cast<uint8_t>(mBounds.width - 2),
+        static_cast<uint8_t>(mBounds.height - 2)};
+    canvas.fill(inside, false);
+    canvas.fill({inside.x, inside.y, filled(mValue), inside.height});
+}
+
+uint8_t ProgressBar::filled(uint16_t value) {
+    const uint8_t inside = mBounds.width > 2 ? mBounds.width - 2 : 0;
+
+    return kMax == 0 ? inside : static_cast<uint32_t>(inside) * value / kMax;
+}
+
+ListView::ListView(const nokia_lcd::Rect &bounds, const char *const items[],
+                   uint8_t count)
+    : Widget(bounds),
+      mItems{items},
+      kCount{count},
+      kLines{static_cast<uint8_t>(bounds.height / kLine_height)},
+      mSelected{0},
+      mFirst{0} {}
+
+bool ListView::setSelected(uint8_t index) {
+    if (index >= kCount) {
+        return true;
+    }
+    if (index == mSelected) {
+        return false;
+    }
+
+    const uint8_t previous = mSelected;
+    mSelected = index;
+    if (index < mFirst) {
+        mFirst = index;
+    } else if (kLines > 0 && index >= mFirst + kLines) {
+        mFirst = index - kLines + 1;
+    } else {
+        damage(line(previous - mFirst));
+        damage(line(index - mFirst));
+        return false;
+    }
+    // Every line shows another item after scrolling
+    damage();
+
+    return false;
+}
+
+uint8_t ListView::getSelected() { return mSelected; }
+
+void ListView::render(WidgetCanvas &canvas) {
+    for (uint8_t i = 0; i < kLines && mFirst + i < kCount; i++) {
+        const nokia_lcd::Rect area = line(i);
+        const bool is_selected = mFirst + i == mSelected;
+        if (is_selected) {
+            canvas.fill(area);
+        }
+        canvas.print(area.x + 1, area.y, mItems[mFirst + i], !is_selected);
+    }
+}
+
+nokia_lcd::Rect ListView::line(uint8_t line) {
+    return {mBounds.x, static_cast<uint8_t>(mBounds.y + line * kLine_height),
+            mBounds.width, kLine_height};
+}
+
+ModalBox::ModalBox(const nokia_lcd::Rect &bounds, const char *string)
+    : Label(bounds, string, nokia_lcd::Alignment::kCenter) {}
+
+void ModalBox::render(WidgetCanvas &canvas) {
+    if (mBounds.width < 2 || mBounds.height < 2) {
+        return;
+    }
+    canvas.fill(mBounds);
+    canvas.fill({static_cast<uint8_t>(mBounds.x + 1),
+                 static_cast<uint8_t>(mBounds.y + 1),
+                 static_cast<uint8_t>(mBounds.width - 2),
+                 static_cast<uint8_t>(mBounds.height - 2)},
+                false);
+    const unsigned int width = canvas.measure(mText);
+    const unsigned int x =
+        width < mBounds.width ? mBounds.x + (mBounds.width - width) / 2
+                              : mBounds.x + 1;
+    const uint8_t y = mBounds.height > kLine_height
+                          ? mBounds.y + (mBounds.height - kLine_height) / 2
+                          : mBounds.y;
+    canvas.print(x, y, mText);
+}
+
+WidgetScreen::WidgetScreen(Nokia_LCD &lcd) : mLcd{lcd}, mWidgets{nullptr} {
+    invalidate();
+}
+
+void WidgetScreen::add(Widget &widget, uint8_t z) {
+    remove(widget);
+    widget.mZ = z;
+    widget.mScreen = this;
+    Widget **position = &mWidgets;
+    while (*position != nullptr && (*position)->mZ <= z) {
+        position = &(*position)->mNext;
+    }
+    widget.mNext = *position;
+    *position = &widget;
+    damage(widget.mBounds);
+}
+
+void WidgetScreen::remove(Widget &widget) {
+    for (Widget **position = &mWidgets; *position != nullptr;
+         position = &(*position)->mNext) {
+        if (*position == &widget) {
+            *position = widget.mNext;
+            widget.mNext = nullptr;
+            widget.mScreen = nullptr;
+            damage(widget.mBounds);
+            return;
+        }
+    }
+}
+
+void WidgetScreen::damage(const nokia_lcd::Rect &area) {
+    if (area.width == 0 || area.height == 0 || area.x >= kColumns) {
+        return;
+    }
+    const unsigned int right = area.x + area.width - 1;
+    const uint8_t last = right < kColumns ? right : kColumns - 1;
+    const unsigned int bottom = (area.y + area.height - 1) / kRows_per_page;
+    for (unsigned int page = area.y / kRows_per_page;
+         page <= bottom && page < kPages; page++) {
+        if (mDamage_first[page] == kClean || area.x < mDamage_first[page]) {
+            mDamage_first[page] = area.x;
+        }
+        if (mDamage_last[page] == kClean || last > mDamage_last[page]) {
+            mDamage_last[page] = last;
+        }
+    }
+}
+
+void WidgetScreen::invalidate() {
+    for (uint8_t page = 0; page < kPages; page++) {
+        mDamage_first[page] = 0;
+        mDamage_last[page] = kColumns - 1;
+    }
+}
+
+bool WidgetScreen::update() {
+    bool sent = false;
+    mLcd.beginTransfer();
+    for (uint8_t page = 0; page < kPages; page++) {
+        if (mDamage_first[page] != kClean) {
+            render(page);
+            sent = true;
+        }
+    }
+    mLcd.endTransfer();
+
+    return sent;
+}
+
+void WidgetScreen::render(uint8_t page) {
+    const uint8_t first = mDamage_first[page];
+    const uint8_t last = mDamage_last[page];
+    mDamage_first[page] = kClean;
+    mDamage_last[page] = kClean;
+    memset(mColumns + first, 0, last - first + 1);
+
+    WidgetCanvas canvas(mColumns, mLcd.getFont());
+    canvas.mPage = page;
+    for (Widget *widget = mWidgets; widget != nullptr;
+         widget = widget->mNext) {
+        const nokia_lcd::Rect &bounds = widget->mBounds;
+        if (!widget->mVisible || bounds.width == 0 || bounds.height == 0) {
+            continue;
+        }
+        // Only the damaged part of the widget is rendered
+        const unsigned int right = bounds.x + bounds.width - 1;
+        canvas.mLeft = bounds.x > first ? bounds.x : first;
+        canvas.mRight = right < last ? right : last;
+        canvas.mMask = rowMask(page, bounds.y, bounds.y + bounds.height - 1);
+        if (canvas.mLeft > canvas.mRight || canvas.mMask == 0) {
+            continue;
+        }
+        // Widgets are opaque
+        canvas.fill(bounds, false);
+        widget->render(canvas);
+    }
+
+    // Sent as they are, widgets draw inverted parts themselves
+    mLcd.beginTransfer();
+    mLcd.setCursor(first, page);
+    for (uint8_t x = first; x <= last; x++) {
+        mLcd.sendData(mColumns[x]);
+    }
+    mLcd.endTransfer();
+}
@@ -0,0 +1,357 @@
+/**
+ * Widgets (labels, numbers, icons, progress bars, lists and modal boxes) that
+ * remember what they show and redraw themselves when it changes.
+ *
+ * Widgets are placed on a WidgetScreen with a z-order and may overlap: the
+ * ones with a higher z-order are drawn on top and hide what is beneath them.
+ * When the state of a widget changes, it reports the rectangle that has to be
+ * redrawn. The screen then renders only the damaged spans of each row of the
+ * display, one row at a time in a buffer of 84 bytes, and sends them. Nothing
+ * is allocated dynamically: widgets are ordinary (e.g. global) objects and
+ * the screen links them together. The rendered bytes are sent as they are, so
+ * `Nokia_LCD::setInverted()` does not affect widgets, which draw in white on
+ * black themselves where needed.
+ */
+#pragma once
+#include <stdint.h>
+
+#include "Nokia_LCD.h"
+
+namespace nokia_lcd {
+// Widget constants
+// Digits of an unsigned long, 10 on AVR
+const uint8_t kMax_number_decimals = sizeof(unsigned long) == 4 ? 10 : 20;
+// Sign, "0.", the digits and terminator
+const uint8_t kMax_number_text = 1 + 2 + kMax_number_decimals + 1;
+
+// An area of the screen in pixels
+struct Rect {
+    uint8_t x;
+    uint8_t y;
+    uint8_t width;
+    uint8_t height;
+};
+}  // namespace nokia_lcd
+
+/**
+ * The part of a row of the display that a widget is rendered on. Anything
+ * outside of the widget or of the damaged span is left untouched.
+ * Coordinates are in pixels, relative to the screen.
+ */
+class WidgetCanvas {
+public:
+    /**
+     * Colors an area
+     * @param area     The area to be colored
+     * @param is_black Whether the area becomes black instead of white
+     */
+    void fill(const nokia_lcd::Rect &area, bool is_black = true);
+
+    /**
+     * Draws an 8 pixel tall column, laid out like the bytes of `draw()`
+     * @param x        Coordinates on the x-axis
+     * @param y        Coordinates on the y-axis of the top pixel
+     * @param column   The pixels to be drawn, the top one is the lowest bit
+     * @param is_black Whether the pixels are drawn black instead of white
+     */
+    void put(uint8_t x, uint8_t y, unsigned char column, bool is_black = true);
+
+    /**
+     * Prints a single line of text with the font of the display
+     * @param  x        The left edge of the text
+     * @param  y        The top edge of the text
+     * @param  string   The text to be printed
+     * @param  is_black Whether the text is drawn black instead of white
+     * @return          The column after the text
+     */
+    unsigned int print(unsigned int x, uint8_t y, const char *string,
+                       bool is_black = true);
+
+    /**
+     * Returns how wide a line of text is with the font of the display
+     * @param  string The text
+     * @return        The width in pixels
+     */
+    unsigned int measure(const char *string);
+
+private:
+    friend class WidgetScreen;
+
+    WidgetCanvas(unsigned char columns[], const LcdFont *font);
+
+    unsigned char *mColumns;
+    const LcdFont *mFont;
+    uint8_t mPage;
+    uint8_t mLeft;
+    uint8_t mRight;
+    unsigned char mMask;  // The rows of the page that may be changed
+};
+
+class WidgetScreen;
+
+class Widget {
+public:
+    /**
+     * Widget constructor
+     * @param bounds The area the widget covers
+     */
+    explicit Widget(const nokia_lcd::Rect &bounds);
+
+    /**
+     * Returns the area the widget covers
+     * @return The area
+     */
+    const nokia_lcd::Rect &getBounds();
+
+    /**
+     * Shows or hides the widget, uncovering what is beneath it
+     * @param visible Whether the widget is shown
+     */
+    void setVisible(bool visible);
+
+    /**
+     * Returns whether the widget is shown
+     * @return True if the widget is shown | False otherwise
+     */
+    bool isVisible();
+
+    /**
+     * Draws the widget. Widgets are opaque, so the area they cover has been
+     * made white before.
+     * @param canvas Where to draw the widget
+     */
+    virtual void render(WidgetCanvas &canvas) = 0;
+
+protected:
+    /**
+     * Reports that the whole widget has to be redrawn
+     */
+    void damage();
+
+    /**
+     * Reports that a part of the widget has to be redrawn
+     * @param area The area to be redrawn
+     */
+    void damage(const nokia_lcd::Rect &area);
+
+    const nokia_lcd::Rect mBounds;
+
+private:
+    friend class WidgetScreen;
+
+    bool mVisible;
+    uint8_t mZ;
+    WidgetScreen *mScreen;
+    Widget *mNext;  // The widget drawn right after this one
+};
+
+class Label : public Widget {
+public:
+    /**
+     * Label constructor
+     * @param bounds    The area of the label, 8 pixels tall for a line of text
+     * @param string    The text, which has to stay around while it is shown
+     * @param alignment How the text is aligned within the label
+     */
+    Label(const nokia_lcd::Rect &bounds, const char *string = "",
+          nokia_lcd::Alignment alignment = nokia_lcd::Alignment::kLeft);
+
+    /**
+     * Changes the text
+     * @param string The text, which has to stay around while it is shown
+     */
+    void setText(const char *string);
+
+    void render(WidgetCanvas &canvas) override;
+
+protected:
+    const char *mText;
+    const nokia_lcd::Alignment kAlignment;
+};
+
+class NumberLabel : public Label {
+public:
+    /**
+     * NumberLabel constructor
+     * @param bounds    The area of the number
+     * @param decimals  How many of the last digits are decimals, e.g. with 1
+     *                  the value 215 is shown as 21.5, up to the 10 digits of a long
+     * @param alignment How the number is aligned within the label
+     */
+    NumberLabel(const nokia_lcd::Rect &bounds, uint8_t decimals = 0,
+                nokia_lcd::Alignment alignment = nokia_lcd::Alignment::kRight);
+
+    /**
+     * Changes the number. The label is only redrawn if what it shows changes.
+     * @param value The number, in units of the last digit
+     */
+    void setValue(long value);
+
+private:
+    const uint8_t kDecimals;
+    char mNumber[nokia_lcd::kMax_number_text];
+};
+
+class Icon : public Widget {
+public:
+    /**
+     * Icon constructor
+     * @param bounds            The area of the icon, as wide as the bitmap
+     * @param bitmap            The bitmap, laid out like the ones of `draw()`
+     * @param read_from_progmem Whether the bitmap is stored in flash memory
+     *                          instead of SRAM. Default read from flash.
+     */
+    Icon(const nokia_lcd::Rect &bounds, const unsigned char bitmap[],
+         bool read_from_progmem = true);
+
+    /**
+     * Changes the bitmap, which has to be of the same size
+     * @param bitmap The bitmap
+     */
+    void setBitmap(const unsigned char bitmap[]);
+
+    void render(WidgetCanvas &canvas) override;
+
+private:
+    const unsigned char *mBitmap;
+    const bool kRead_from_progmem;
+};
+
+class ProgressBar : public Widget {
+public:
+    /**
+     * ProgressBar constructor
+     * @param bounds The area of the bar, including its 1 pixel frame
+     * @param max    The value of a full bar
+     */
+    ProgressBar(const nokia_lcd::Rect &bounds, uint16_t max = 100);
+
+    /**
+     * Changes how full the bar is. Only the columns that changed are redrawn.
+     * @param value The value, between 0 and the value of a full bar
+     */
+    void setValue(uint16_t value);
+
+    void render(WidgetCanvas &canvas) override;
+
+private:
+    /**
+     * Returns how many columns inside the frame are filled
+     * @param  value The value
+     * @return       The number of columns
+     */
+    uint8_t filled(uint16_t value);
+
+    const uint16_t kMax;
+    uint16_t mValue;
+};
+
+class ListView : public Widget {
+public:
+    /**
+     * ListView constructor
+     * @param bounds The area of the list, 8 pixels tall for every line
+     * @param items  The text of each item, which has to stay around
+     * @param count  The number of items
+     */
+    ListView(const nokia_lcd::Rect &bounds, const char *const items[],
+             uint8_t count);
+
+    /**
+     * Highlights an item, scrolling the list if the item is not shown. When
+     * it does not scroll, only the two items that changed are redrawn.
+     * @param  index The index of the item
+     * @return       True if out of bounds error | False otherwise
+     */
+    bool setSelected(uint8_t index);
+
+    /**
+     * Returns the highlighted item
+     * @return The index of the item
+     */
+    uint8_t getSelected();
+
+    void render(WidgetCanvas &canvas) override;
+
+private:
+    /**
+     * Returns the area of a line of the list
+     * @param  line The line, counted from the top of the list
+     * @return      The area
+     */
+    nokia_lcd::Rect line(uint8_t line);
+
+    const char *const *mItems;
+    const uint8_t kCount;
+    const uint8_t kLines;
+    uint8_t mSelected;
+    uint8_t mFirst;  // The item on the top line
+};
+
+class ModalBox : public Label {
+public:
+    /**
+     * ModalBox constructor. Boxes are usually added with the highest z-order
+     * and hidden until they are needed.
+     * @param bounds The area of the box, including its 1 pixel frame
+     * @param string The text shown in the middle of the box
+     */
+    ModalBox(const nokia_lcd::Rect &bounds, const char *string = "");
+
+    void render(WidgetCanvas &canvas) override;
+};
+
+class WidgetScreen {
+public:
+    /**
+     * WidgetScreen constructor. The whole display is drawn by the first
+     * update.
+     * @param lcd The (initialized) display the widgets are shown on
+     */
+    WidgetScreen(Nokia_LCD &lcd);
+
+    /**
+     * Places a widget on the screen. Widgets with the same z-order are drawn
+     * in the order they were added.
+     * @param widget The widget, which has to stay around while it is added
+     * @param z      Widgets with a higher z-order cover the lower ones
+     */
+    void add(Widget &widget, uint8_t z = 0);
+
+    /**
+     * Removes a widget from the screen
+     * @param widget The widget
+     */
+    void remove(Widget &widget);
+
+    /**
+     * Marks an area to be redrawn by the next update
+     * @param area The area
+     */
+    void damage(const nokia_lcd::Rect &area);
+
+    /**
+     * Marks the whole screen to be redrawn by the next update
+     */
+    void invalidate();
+
+    /**
+     * Redraws and sends the damaged areas
+     * @return True if anything was sent | False otherwise
+     */
+    bool update();
+
+private:
+    /**
+     * Renders the damaged span of a row of the display and sends it
+     * @param page The row, can be between 0 and 5
+     */
+    void render(uint8_t page);
+
+    Nokia_LCD &mLcd;
+    Widget *mWidgets;  // The bottom one, the others follow in z-order
+    unsigned char mColumns[nokia_lcd::kDisplay_max_width];
+    // The damaged span of columns of each row, both 0xFF if none
+    uint8_t mDamage_first[nokia_lcd::kDisplay_max_rows];
+    uint8_t mDamage_last[nokia_lcd::kDisplay_max_rows];
+};
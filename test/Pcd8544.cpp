@@ -0,0 +1,181 @@
+#include "Pcd8544.h"
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+// The first display of the list listening to the bus
+Pcd8544 *gDisplays = nullptr;
+
+// Function set and its flags, in both instruction sets
+const uint8_t kFunction_set = 0x20;
+const uint8_t kPower_down = 0x04;
+const uint8_t kVertical = 0x02;
+const uint8_t kExtended = 0x01;
+
+const char *const kDisplay_modes[] = {"blank", "all segments on", "normal",
+                                      "inverse"};
+}  // namespace
+
+Pcd8544::Pcd8544(uint8_t dc_pin, uint8_t ce_pin, uint8_t rst_pin)
+    : kDc_pin{dc_pin},
+      kCe_pin{ce_pin},
+      kRst_pin{rst_pin},
+      mBus_bytes{0},
+      mErrors{0},
+      mRecording{false},
+      mNext{gDisplays} {
+    // The display RAM is not cleared on reset, start with a known content
+    memset(mRam, 0, sizeof(mRam));
+    reset();
+    gDisplays = this;
+}
+
+Pcd8544::~Pcd8544() {
+    for (Pcd8544 **display = &gDisplays; *display; display = &(*display)->mNext) {
+        if (*display == this) {
+            *display = mNext;
+            break;
+        }
+    }
+}
+
+bool Pcd8544::getPixel(uint8_t x, uint8_t y) const {
+    return mRam[y / 8][x] & (1 << (y % 8));
+}
+
+std::string Pcd8544::toPbm() const {
+    char header[160];
+    snprintf(header, sizeof(header),
+             "P1\n"
+             "# %s, %s mode, %s addressing\n"
+             "# contrast %u, bias %u, temperature coefficient %u\n"
+             "%u %u\n",
+             mPower_down ? "power down" : "power on",
+             kDisplay_modes[mDisplay_mode],
+             mVertical ? "vertical" : "horizontal", mContrast, mBias,
+             mTemperature_coefficient, kColumns, kHeight);
+
+    std::string pbm = header;
+    for (uint8_t y = 0; y < kHeight; y++) {
+        for (uint8_t x = 0; x < kColumns; x++) {
+            pbm += getPixel(x, y) ? '1' : '0';
+        }
+        pbm += '\n';
+    }
+
+    return pbm;
+}
+
+bool Pcd8544::isPoweredDown() const { return mPower_down; }
+
+unsigned long Pcd8544::getBusBytes() const { return mBus_bytes; }
+
+unsigned long Pcd8544::getErrors() const { return mErrors; }
+
+void Pcd8544::recordData() {
+    mRecording = true;
+    mRecorded_data.clear();
+}
+
+const std::vector<uint8_t> &Pcd8544::getRecordedData() const {
+    return mRecorded_data;
+}
+
+void Pcd8544::onByte(uint8_t byte) {
+    for (Pcd8544 *display = gDisplays; display; display = display->mNext) {
+        if (digitalRead(display->kCe_pin) == LOW) {
+            display->receive(digitalRead(display->kDc_pin) == HIGH, byte);
+        }
+    }
+}
+
+void Pcd8544::onPinChange(uint8_t pin, uint8_t value) {
+    for (Pcd8544 *display = gDisplays; display; display = display->mNext) {
+        if (pin == display->kRst_pin && value == LOW) {
+            display->reset();
+        }
+    }
+}
+
+void Pcd8544::receive(bool is_data, uint8_t byte) {
+    mBus_bytes++;
+    if (!is_data) {
+        execute(byte);
+        return;
+    }
+
+    if (mRecording) {
+        mRecorded_data.push_back(byte);
+    }
+    mRam[mY][mX] = byte;
+    // The address counter wraps around the whole display RAM
+    if (mVertical) {
+        if (++mY == kPages) {
+            mY = 0;
+            mX = (mX + 1) % kColumns;
+        }
+    } else if (++mX == kColumns) {
+        mX = 0;
+        mY = (mY + 1) % kPages;
+    }
+}
+
+void Pcd8544::execute(uint8_t command) {
+    if ((command & 0xF8) == kFunction_set) {
+        mPower_down = command & kPower_down;
+        mVertical = command & kVertical;
+        mExtended = command & kExtended;
+        return;
+    }
+    if (command == 0x00) {
+        return;  // No operation
+    }
+
+    if (mExtended) {
+        if (command & 0x80) {
+            mContrast = command & 0x7F;
+        } else if ((command & 0xF8) == 0x10) {
+            mBias = command & 0x07;
+        } else if ((command & 0xFC) == 0x04) {
+            mTemperature_coefficient = command & 0x03;
+        } else {
+            mErrors++;
+        }
+        return;
+    }
+
+    if (command & 0x80) {
+        const uint8_t x = command & 0x7F;
+        if (x < kColumns) {
+            mX = x;
+        } else {
+            mErrors++;
+        }
+    } else if (command & 0x40) {
+        const uint8_t y = command & 0x07;
+        if ((command & 0x38) == 0 && y < kPages) {
+            mY = y;
+        } else {
+            mErrors++;
+        }
+    } else if ((command & 0xFA) == 0x08) {
+        // The D and E bits
+        mDisplay_mode = (command & 0x04) >> 1 | (command & 0x01);
+    } else {
+        mErrors++;
+    }
+}
+
+void Pcd8544::reset() {
+    mX = 0;
+    mY = 0;
+    mPower_down = true;
+    mVertical = false;
+    mExtended = false;
+    mDisplay_mode = 0;
+    mContrast = 0;
+    mBias = 0;
+    mTemperature_coefficient = 0;
+}
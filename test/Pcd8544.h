@@ -0,0 +1,99 @@
+/**
+ * An emulated PCD8544, the controller of the Nokia 5110 display. It listens
+ * to the pins and the bus of the host build of the Arduino core, executes the
+ * commands it receives and keeps its display RAM, so tests can compare what
+ * would be shown against golden images.
+ */
+#pragma once
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+class Pcd8544 {
+public:
+    static const uint8_t kColumns = 84;
+    static const uint8_t kPages = 6;
+    static const uint8_t kHeight = kPages * 8;
+
+    /**
+     * Pcd8544 constructor, the display listens to the bus until it is
+     * destroyed
+     * @param dc_pin  Data or command pin (DC)
+     * @param ce_pin  Chip select pin (CE)
+     * @param rst_pin Reset pin (RST)
+     */
+    Pcd8544(uint8_t dc_pin, uint8_t ce_pin, uint8_t rst_pin);
+    ~Pcd8544();
+
+    /**
+     * Returns whether a pixel of the display RAM is set
+     * @param  x The column, between 0 and 83
+     * @param  y The row of pixels, between 0 and 47
+     * @return   True if the pixel is dark | False otherwise
+     */
+    bool getPixel(uint8_t x, uint8_t y) const;
+
+    /**
+     * Returns the display RAM as a plain PBM image. Comments before the
+     * pixels describe the state of the controller.
+     */
+    std::string toPbm() const;
+
+    /**
+     * Returns whether the display is in power-down mode
+     */
+    bool isPoweredDown() const;
+
+    /**
+     * Returns how many bytes were received, commands and data alike
+     */
+    unsigned long getBusBytes() const;
+
+    /**
+     * Returns how many invalid addresses or instructions were received
+     */
+    unsigned long getErrors() const;
+
+    /**
+     * Keeps every data byte received from now on, in the order they arrive,
+     * e.g. to check what was sent beyond the 504 bytes of the display RAM
+     */
+    void recordData();
+
+    /**
+     * Returns the data bytes received since `recordData()`
+     */
+    const std::vector<uint8_t> &getRecordedData() const;
+
+    /**
+     * Called by the host build for every byte on the bus and every change of
+     * the reset pin
+     */
+    static void onByte(uint8_t byte);
+    static void onPinChange(uint8_t pin, uint8_t value);
+
+private:
+    void receive(bool is_data, uint8_t byte);
+    void execute(uint8_t command);
+    void reset();
+
+    const uint8_t kDc_pin;
+    const uint8_t kCe_pin;
+    const uint8_t kRst_pin;
+    uint8_t mRam[kPages][kColumns];
+    uint8_t mX;
+    uint8_t mY;
+    bool mPower_down;
+    bool mVertical;
+    bool mExtended;
+    uint8_t mDisplay_mode;
+    uint8_t mContrast;
+    uint8_t mBias;
+    uint8_t mTemperature_coefficient;
+    unsigned long mBus_bytes;
+    unsigned long mErrors;
+    bool mRecording;
+    std::vector<uint8_t> mRecorded_data;
+    Pcd8544 *mNext;  // The displays listening to the bus form a list
+};
@@ -0,0 +1,37 @@
+#pragma once
+#include <LCD_Fonts.h>
+
+/**
+ * Generated by extras/nokia_lcd_convert.py from default_5x8.pbm
+ **/
+
+namespace Digits_LCD_Fonts {
+    const unsigned char hSpace[] = {0x00};
+    const unsigned char hSpaceSize = 1;
+
+    /* Packed glyphs:
+    7 bits of each column, starting with row 0, one column after
+    the other and the lowest bit first. */
+    const unsigned char kBitmap[] PROGMEM = {
+        0x08, 0x04, 0x02, 0x81, 0x00, 0x80, 0xc1, 0xbe, 0x68, 0xb2, 0xe8, 0x03,
+        0x08, 0xff, 0x40, 0x61, 0x38, 0x9a, 0x34, 0x86, 0x82, 0xc5, 0x65, 0x0c,
+        0x43, 0x91, 0xfc, 0x21, 0xa7, 0x62, 0xb1, 0x98, 0xe3, 0x29, 0x93, 0x49,
+        0x58, 0x20, 0x9e, 0x28, 0x0c, 0x6c, 0xc9, 0x64, 0xd2, 0x66, 0x48, 0x26,
+        0x53, 0x1e, 0x80, 0xcd, 0x06,
+    };
+
+    const uint16_t kColumns[] PROGMEM = {
+        0, 5, 8, 13, 17, 22, 27, 32, 37, 42, 47, 52,
+        57, 60,
+    };
+
+    const GlyphRange kRanges[] PROGMEM = {
+        {0x2d, 0x2e, 0}, // - to .
+        {0x30, 0x3a, 2}, // 0 to :
+    };
+
+    const PackedFont kPacked_font{kBitmap, kColumns, kRanges, 2, 5, 7, 0,
+                                  0x2d};
+    const LcdFont DigitsFont{&kPacked_font, hSpace, hSpaceSize};
+
+}  // namespace Digits_LCD_Fonts
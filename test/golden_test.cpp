@@ -0,0 +1,127 @@
+/**
+ * Runs every scenario on an emulated display and compares the display RAM
+ * against the golden images.
+ *
+ * Usage: golden_test <golden directory> [--update]
+ *
+ * With `--update` the golden images are written instead of compared, after
+ * a change that is meant to alter what is drawn. Review them before checking
+ * them in. The image of a failing scenario is written next to the test as
+ * `<name>.actual.pbm`.
+ */
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include "scenario.h"
+
+namespace {
+test::Scenario *gScenarios = nullptr;
+unsigned int gFailures = 0;
+
+std::string readFile(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    std::ostringstream content;
+    content << file.rdbuf();
+    return file ? content.str() : std::string();
+}
+
+bool writeFile(const std::string &path, const std::string &content) {
+    std::ofstream file(path, std::ios::binary);
+    file << content;
+    return static_cast<bool>(file);
+}
+
+// Runs a scenario, returns whether it passed
+bool run(const test::Scenario &scenario, const std::string &golden_directory,
+         bool update) {
+    const unsigned int failures = gFailures;
+    // Only the chip select of the display is driven before `begin()`
+    digitalWrite(test::kCe_pin, HIGH);
+    Pcd8544 display(test::kDc_pin, test::kCe_pin, test::kRst_pin);
+    Nokia_LCD lcd(test::kClk_pin, test::kDin_pin, test::kDc_pin,
+                  test::kCe_pin, test::kRst_pin);
+    lcd.begin();
+    const unsigned long bus_bytes_before = display.getBusBytes();
+    scenario.run(lcd, display);
+    const unsigned long bus_bytes = display.getBusBytes() - bus_bytes_before;
+
+    if (bus_bytes > scenario.max_bus_bytes) {
+        printf("%s: %lu bus bytes, at most %lu expected\n", scenario.name,
+               bus_bytes, scenario.max_bus_bytes);
+        gFailures++;
+    }
+    if (display.getErrors() > 0) {
+        printf("%s: %lu invalid commands\n", scenario.name,
+               display.getErrors());
+        gFailures++;
+    }
+
+    const std::string image = display.toPbm();
+    const std::string golden_path =
+        golden_directory + "/" + scenario.name + ".pbm";
+    if (update) {
+        if (!writeFile(golden_path, image)) {
+            printf("%s: cannot write %s\n", scenario.name,
+                   golden_path.c_str());
+            gFailures++;
+        }
+    } else if (readFile(golden_path) != image) {
+        const std::string actual_path =
+            std::string(scenario.name) + ".actual.pbm";
+        writeFile(actual_path, image);
+        printf("%s: differs from %s, see %s\n", scenario.name,
+               golden_path.c_str(), actual_path.c_str());
+        gFailures++;
+    }
+
+    const bool passed = gFailures == failures;
+    printf("%s %s (%lu/%lu bus bytes)\n", passed ? "PASS" : "FAIL",
+           scenario.name, bus_bytes, scenario.max_bus_bytes);
+    return passed;
+}
+}  // namespace
+
+test::Registration::Registration(Scenario &scenario) {
+    scenario.next = gScenarios;
+    gScenarios = &scenario;
+}
+
+void test::fail(const char *file, int line, const char *condition) {
+    printf("%s:%d: expected %s\n", file, line, condition);
+    gFailures++;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2 || (argc == 3 && strcmp(argv[2], "--update") != 0) ||
+        argc > 3) {
+        printf("Usage: %s <golden directory> [--update]\n", argv[0]);
+        return 2;
+    }
+    const bool update = argc == 3;
+
+    // Always run in the same order, the clock is shared by all scenarios
+    std::vector<const test::Scenario *> scenarios;
+    for (test::Scenario *scenario = gScenarios; scenario;
+         scenario = scenario->next) {
+        scenarios.push_back(scenario);
+    }
+    std::sort(scenarios.begin(), scenarios.end(),
+              [](const test::Scenario *a, const test::Scenario *b) {
+                  return strcmp(a->name, b->name) < 0;
+              });
+
+    unsigned int failed = 0;
+    for (const test::Scenario *scenario : scenarios) {
+        failed += run(*scenario, argv[1], update) ? 0 : 1;
+    }
+    printf("%u of %u scenarios failed\n", failed,
+           static_cast<unsigned int>(scenarios.size()));
+
+    return failed == 0 ? 0 : 1;
+}
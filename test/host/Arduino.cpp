@@ -0,0 +1,172 @@
+#include <Arduino.h>
+#include <SPI.h>
+#include <stdio.h>
+
+#include "../Pcd8544.h"
+
+namespace {
+// Sending a byte takes 8 clock cycles of a 1 MHz bus
+const unsigned long kByte_micros = 8;
+
+uint8_t gPins[256];
+unsigned long gMicros = 0;
+
+void sendToDisplays(uint8_t byte) {
+    gMicros += kByte_micros;
+    Pcd8544::onByte(byte);
+}
+}  // namespace
+
+SPIClass SPI;
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+    gPins[pin] = value == LOW ? LOW : HIGH;
+    Pcd8544::onPinChange(pin, gPins[pin]);
+}
+
+int digitalRead(uint8_t pin) { return gPins[pin]; }
+
+void shiftOut(uint8_t, uint8_t, uint8_t bit_order, uint8_t value) {
+    if (bit_order == LSBFIRST) {
+        uint8_t reversed = 0;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            reversed |= ((value >> bit) & 1) << (7 - bit);
+        }
+        value = reversed;
+    }
+    sendToDisplays(value);
+}
+
+uint8_t SPIClass::transfer(uint8_t data) {
+    sendToDisplays(data);
+    return 0;
+}
+
+unsigned long micros() { return gMicros; }
+
+unsigned long millis() { return gMicros / 1000; }
+
+void delay(unsigned long ms) { gMicros += ms * 1000; }
+
+void delayMicroseconds(unsigned int us) { gMicros += us; }
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+    size_t n = 0;
+    while (n < size && write(buffer[n])) {
+        n++;
+    }
+    return n;
+}
+
+size_t Print::print(const __FlashStringHelper *string) {
+    return write(reinterpret_cast<const char *>(string));
+}
+
+size_t Print::print(const String &string) { return write(string.c_str()); }
+
+size_t Print::print(const char string[]) { return write(string); }
+
+size_t Print::print(char character) { return write(character); }
+
+size_t Print::print(unsigned char number, int base) {
+    return print(static_cast<unsigned long>(number), base);
+}
+
+size_t Print::print(int number, int base) {
+    return print(static_cast<long>(number), base);
+}
+
+size_t Print::print(unsigned int number, int base) {
+    return print(static_cast<unsigned long>(number), base);
+}
+
+size_t Print::print(long number, int base) {
+    if (base == DEC && number < 0) {
+        return print('-') + print(0UL - number, base);
+    }
+    return print(static_cast<unsigned long>(number), base);
+}
+
+size_t Print::print(unsigned long number, int base) {
+    if (base == 0) {
+        return write(static_cast<uint8_t>(number));
+    }
+    base = base < 2 ? DEC : base;
+    char digits[8 * sizeof(number) + 1];
+    char *digit = digits + sizeof(digits) - 1;
+    *digit = '\0';
+    do {
+        const int value = number % base;
+        *--digit = value < 10 ? '0' + value : 'A' + value - 10;
+        number /= base;
+    } while (number > 0);
+    return write(digit);
+}
+
+size_t Print::print(double number, int digits) {
+    char text[48];
+    snprintf(text, sizeof(text), "%.*f", digits, number);
+    return write(text);
+}
+
+size_t Print::print(const Printable &printable) {
+    return printable.printTo(*this);
+}
+
+size_t Print::println(const __FlashStringHelper *string) {
+    return print(string) + println();
+}
+
+size_t Print::println(const String &string) {
+    return print(string) + println();
+}
+
+size_t Print::println(const char string[]) {
+    return print(string) + println();
+}
+
+size_t Print::println(char character) { return print(character) + println(); }
+
+size_t Print::println(unsigned char number, int base) {
+    return print(number, base) + println();
+}
+
+size_t Print::println(int number, int base) {
+    return print(number, base) + println();
+}
+
+size_t Print::println(unsigned int number, int base) {
+    return print(number, base) + println();
+}
+
+size_t Print::println(long number, int base) {
+    return print(number, base) + println();
+}
+
+size_t Print::println(unsigned long number, int base) {
+    return print(number, base) + println();
+}
+
+size_t Print::println(double number, int digits) {
+    return print(number, digits) + println();
+}
+
+size_t Print::println(const Printable &printable) {
+    return print(printable) + println();
+}
+
+size_t Print::println() { return write("\r\n"); }
+
+size_t Stream::readBytes(char *buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        const int c = read();
+        if (c < 0) {
+            break;
+        }
+        buffer[count++] = c;
+    }
+    return count;
+}
@@ -0,0 +1,113 @@
+/**
+ * The part of the Arduino core the library uses, so that it can be built and
+ * tested on the host. Pins are only remembered and what is shifted out, or
+ * sent over SPI, goes to the emulated displays, see `Pcd8544.h`. Time only
+ * passes while bytes are being sent or when waiting.
+ */
+#pragma once
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define LSBFIRST 0
+#define MSBFIRST 1
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+// Flash memory is read like RAM, as on most architectures but AVR
+#define PROGMEM
+
+class __FlashStringHelper;
+#define F(string_literal) \
+    (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+void shiftOut(uint8_t data_pin, uint8_t clock_pin, uint8_t bit_order,
+              uint8_t value);
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+class String {
+public:
+    String(const char *string = "") : mString{string} {}
+    const char *c_str() const { return mString.c_str(); }
+    const char *begin() const { return c_str(); }
+    const char *end() const { return c_str() + mString.size(); }
+    unsigned int length() const { return mString.size(); }
+
+private:
+    std::string mString;
+};
+
+class Print;
+
+class Printable {
+public:
+    virtual ~Printable() {}
+    virtual size_t printTo(Print &p) const = 0;
+};
+
+class Print {
+public:
+    virtual ~Print() {}
+    virtual size_t write(uint8_t) = 0;
+    size_t write(const char *str) {
+        return str == nullptr ? 0 : write(str, strlen(str));
+    }
+    virtual size_t write(const uint8_t *buffer, size_t size);
+    size_t write(const char *buffer, size_t size) {
+        return write(reinterpret_cast<const uint8_t *>(buffer), size);
+    }
+
+    // The overloads of the Arduino core, so that the ones of Nokia_LCD are
+    // checked against them
+    size_t print(const __FlashStringHelper *string);
+    size_t print(const String &string);
+    size_t print(const char string[]);
+    size_t print(char character);
+    size_t print(unsigned char number, int base = DEC);
+    size_t print(int number, int base = DEC);
+    size_t print(unsigned int number, int base = DEC);
+    size_t print(long number, int base = DEC);
+    size_t print(unsigned long number, int base = DEC);
+    size_t print(double number, int digits = 2);
+    size_t print(const Printable &printable);
+
+    size_t println(const __FlashStringHelper *string);
+    size_t println(const String &string);
+    size_t println(const char string[]);
+    size_t println(char character);
+    size_t println(unsigned char number, int base = DEC);
+    size_t println(int number, int base = DEC);
+    size_t println(unsigned int number, int base = DEC);
+    size_t println(long number, int base = DEC);
+    size_t println(unsigned long number, int base = DEC);
+    size_t println(double number, int digits = 2);
+    size_t println(const Printable &printable);
+    size_t println();
+};
+
+class Stream : public Print {
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    size_t readBytes(char *buffer, size_t length);
+    size_t readBytes(uint8_t *buffer, size_t length) {
+        return readBytes(reinterpret_cast<char *>(buffer), length);
+    }
+};
@@ -0,0 +1,24 @@
+/**
+ * The hardware SPI of the host build, which sends every byte to the emulated
+ * displays, see `Arduino.h`.
+ */
+#pragma once
+#include <Arduino.h>
+
+#define SPI_MODE0 0x00
+
+class SPISettings {
+public:
+    SPISettings() {}
+    SPISettings(uint32_t, uint8_t, uint8_t) {}
+};
+
+class SPIClass {
+public:
+    void begin() {}
+    void beginTransaction(SPISettings) {}
+    uint8_t transfer(uint8_t data);
+    void endTransaction() {}
+};
+
+extern SPIClass SPI;
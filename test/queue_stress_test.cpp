@@ -0,0 +1,105 @@
+/**
+ * Fills a Nokia_LCD_Queue from a second thread while the main thread services
+ * it, as an interrupt and the main loop would, and checks that every
+ * operation reaches the display once and in the order it was posted.
+ *
+ * Usage: queue_stress_test
+ */
+#include <Arduino.h>
+#include <Nokia_LCD_Queue.h>
+#include <stdio.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "Pcd8544.h"
+#include "scenario.h"
+
+namespace {
+const unsigned long kOperations = 200000;
+
+// The pattern and the count of the operation with the supplied sequence
+// number, so that lost, repeated or reordered operations show in the data
+uint8_t patternOf(unsigned long sequence) {
+    return static_cast<uint8_t>(sequence);
+}
+
+uint8_t countOf(unsigned long sequence) { return 1 + sequence % 3; }
+}  // namespace
+
+int main() {
+    digitalWrite(test::kCe_pin, HIGH);
+    Pcd8544 display(test::kDc_pin, test::kCe_pin, test::kRst_pin);
+    Nokia_LCD lcd(test::kClk_pin, test::kDin_pin, test::kDc_pin,
+                  test::kCe_pin, test::kRst_pin);
+    lcd.begin();
+    display.recordData();
+    Nokia_LCD_Queue queue(lcd);
+
+    std::atomic<bool> posted_all{false};
+    unsigned long full = 0;
+    std::thread producer([&queue, &posted_all, &full] {
+        for (unsigned long i = 0; i < kOperations; i++) {
+            // Retried until the consumer makes room, nothing is dropped
+            while (!queue.fill(patternOf(i), countOf(i))) {
+                full++;
+                std::this_thread::yield();
+            }
+        }
+        posted_all = true;
+    });
+
+    unsigned long services = 0;
+    unsigned long serviced = 0;
+    while (!posted_all) {
+        const uint8_t count = queue.service();
+        if (count == 0) {
+            std::this_thread::yield();
+            continue;
+        }
+        services++;
+        serviced += count;
+    }
+    producer.join();
+    // Whatever was posted after the last service
+    for (uint8_t count = queue.service(); count > 0; count = queue.service()) {
+        services++;
+        serviced += count;
+    }
+
+    std::vector<uint8_t> expected;
+    for (unsigned long i = 0; i < kOperations; i++) {
+        expected.insert(expected.end(), countOf(i), patternOf(i));
+    }
+    const std::vector<uint8_t> &received = display.getRecordedData();
+    unsigned long failures = 0;
+    if (serviced != kOperations) {
+        printf("%lu operations serviced, %lu posted\n", serviced,
+               kOperations);
+        failures++;
+    }
+    if (received.size() != expected.size()) {
+        printf("%lu data bytes received, %lu expected\n",
+               static_cast<unsigned long>(received.size()),
+               static_cast<unsigned long>(expected.size()));
+        failures++;
+    }
+    for (size_t i = 0; i < received.size() && i < expected.size(); i++) {
+        if (received[i] != expected[i]) {
+            printf("data byte %lu is 0x%02X, 0x%02X expected\n",
+                   static_cast<unsigned long>(i), received[i], expected[i]);
+            failures++;
+            break;
+        }
+    }
+    if (display.getErrors() > 0) {
+        printf("%lu invalid commands\n", display.getErrors());
+        failures++;
+    }
+
+    printf("%s queue stress (%lu operations in %lu services, queue full %lu "
+           "times)\n",
+           failures == 0 ? "PASS" : "FAIL", serviced, services, full);
+    return failures == 0 ? 0 : 1;
+}
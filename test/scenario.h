@@ -0,0 +1,60 @@
+/**
+ * Scenarios of the golden image tests. Each one drives the library on a
+ * freshly initialized display, whose RAM is then compared against
+ * `golden/<name>.pbm`. A scenario fails if the image differs, if more than
+ * `max_bus_bytes` bytes were sent after `begin()`, or if one of its
+ * expectations does not hold.
+ *
+ * @example
+ * SCENARIO(hello, 100) {
+ *     EXPECT(!lcd.print("Hello"));
+ * }
+ */
+#pragma once
+#include <Nokia_LCD.h>
+
+#include "Pcd8544.h"
+
+namespace test {
+// The pins every display of the scenarios is connected to
+const uint8_t kClk_pin = 13;
+const uint8_t kDin_pin = 12;
+const uint8_t kDc_pin = 11;
+const uint8_t kCe_pin = 10;
+const uint8_t kRst_pin = 9;
+const uint8_t kBl_pin = 8;
+
+struct Scenario {
+    const char *name;
+    unsigned long max_bus_bytes;
+    void (*run)(Nokia_LCD &lcd, Pcd8544 &display);
+    Scenario *next;
+};
+
+/**
+ * Adds a scenario to the ones that are run
+ */
+struct Registration {
+    explicit Registration(Scenario &scenario);
+};
+
+/**
+ * Records a failed expectation of the scenario that is running
+ */
+void fail(const char *file, int line, const char *condition);
+}  // namespace test
+
+#define SCENARIO(name, max_bus_bytes)                                  \
+    static void scenario_##name(Nokia_LCD &lcd, Pcd8544 &display);     \
+    static test::Scenario scenario_data_##name{#name, max_bus_bytes,   \
+                                               scenario_##name, nullptr}; \
+    static test::Registration registration_##name{scenario_data_##name}; \
+    static void scenario_##name(Nokia_LCD &lcd __attribute__((unused)), \
+                                Pcd8544 &display __attribute__((unused)))
+
+#define EXPECT(condition)                                   \
+    do {                                                    \
+        if (!(condition)) {                                 \
+            test::fail(__FILE__, __LINE__, #condition);     \
+        }                                                   \
+    } while (false)
@@ -0,0 +1,367 @@
+// Scenarios of the classes built on top of Nokia_LCD
+#include <Nokia_LCD_Chart.h>
+#include <Nokia_LCD_Console.h>
+#include <Nokia_LCD_Dither.h>
+#include <Nokia_LCD_Framebuffer.h>
+#include <Nokia_LCD_Gray.h>
+#include <Nokia_LCD_Group.h>
+#include <Nokia_LCD_Queue.h>
+#include <Nokia_LCD_Scheduler.h>
+#include <Nokia_LCD_Widgets.h>
+
+#include "scenario.h"
+
+namespace {
+const unsigned char kBell[] PROGMEM = {0x20, 0x3C, 0x3E, 0x7F, 0x3E, 0x3C,
+                                       0x20};
+const unsigned char kSmiley[] = {0x3C, 0x42, 0x95, 0xA1, 0xA1,
+                                 0x95, 0x42, 0x3C};
+const char *const kMenu[] = {"Settings", "Display", "Sound",
+                             "Network",  "About",   "Exit"};
+
+// A gradient from white on the left to black on the right, with a circle
+void readGradient(uint8_t y, uint8_t row[], uint8_t width) {
+    for (uint8_t x = 0; x < width; x++) {
+        const int dx = x - 60;
+        const int dy = y - 16;
+        row[x] = dx * dx + dy * dy < 100 ? 0 : 255 - x * 255 / (width - 1);
+    }
+}
+}  // namespace
+
+SCENARIO(console, 2830) {
+    Nokia_LCD_Console console(lcd);
+    console.clear();
+    console.println("Console");
+    console.print("a line that wraps around");
+    console.println('!');
+    // Characters beyond ASCII take a single column each
+    console.println("21\xC2\xB0" "C 5\xC2\xB5s \xE2\x82\xAC" "12\xC2\xB0");
+    console.print('1');
+    console.print('\n');
+    for (char line = 'a'; line <= 'c'; line++) {
+        console.print("line ");
+        console.println(line);
+    }
+}
+
+SCENARIO(console_scroll_unchanged, 1110) {
+    // Scrolling identical lines sends nothing but the new last line
+    Nokia_LCD_Console console(lcd);
+    console.clear();
+    for (int i = 0; i < 6; i++) {
+        console.println("same");
+    }
+    const unsigned long before = display.getBusBytes();
+    console.println("same");
+    EXPECT(display.getBusBytes() - before <= 2 + 14 * 6 + 4);
+}
+
+SCENARIO(framebuffer, 628) {
+    Nokia_LCD_Framebuffer framebuffer(lcd);
+    framebuffer.clear();
+    EXPECT(framebuffer.flush() > 0);
+    // A frame with single pixels, overlapping text and a bitmap
+    for (uint8_t x = 0; x < 84; x += 3) {
+        EXPECT(!framebuffer.setPixel(x, x * 47 / 83));
+    }
+    EXPECT(framebuffer.setPixel(84, 0));
+    EXPECT(framebuffer.getPixel(3, 1));
+    EXPECT(!framebuffer.getPixel(4, 1));
+    EXPECT(framebuffer.setCursor(10, 2));
+    framebuffer.print("frame");
+    EXPECT(framebuffer.setCursor(40, 3));
+    EXPECT(!framebuffer.draw(kSmiley, sizeof(kSmiley), false, 8));
+    EXPECT(!framebuffer.setPixel(3, 1, false));
+    // Changed directly in the buffer
+    framebuffer.getBuffer()[5 * 84 + 80] = 0xFF;
+    framebuffer.markDirty(5, 80, 80);
+    // Setting a pixel to what it was changes nothing
+    EXPECT(!framebuffer.setPixel(0, 0, true));
+    const unsigned int pending = framebuffer.getPendingBytes();
+    EXPECT(framebuffer.flush(20) <= pending);
+    EXPECT(framebuffer.flush() > 0);
+    EXPECT(framebuffer.getPendingBytes() == 0);
+    EXPECT(framebuffer.flush() == 0);
+    // Inversion of the display does not apply to the framebuffer
+    lcd.setInverted(true);
+    framebuffer.setPixel(83, 47);
+    framebuffer.flush();
+}
+
+SCENARIO(framebuffer_double_buffered, 634) {
+    static unsigned char front[nokia_lcd::kFramebuffer_size];
+    Nokia_LCD_Framebuffer framebuffer(lcd, front);
+    // All of the blank front buffer is sent first
+    EXPECT(framebuffer.getPendingBytes() > 0);
+    framebuffer.flush();
+    framebuffer.clear();
+    framebuffer.print("first");
+    framebuffer.setCursor(0, 3);
+    framebuffer.print("frame");
+    // Nothing is sent before the frame is handed over
+    EXPECT(framebuffer.getPendingBytes() == 0);
+    EXPECT(framebuffer.swap());
+    // Partly sent, so the next frame has to wait
+    EXPECT(framebuffer.flush(1) > 0);
+    framebuffer.setCursor(0, 1);
+    framebuffer.print("second");
+    EXPECT(!framebuffer.swap());
+    framebuffer.flush();
+    EXPECT(framebuffer.swap());
+    framebuffer.flush();
+    // Only what differs from the shown frame is sent
+    framebuffer.setCursor(0, 1);
+    framebuffer.print("secant");
+    EXPECT(framebuffer.swap());
+    EXPECT(framebuffer.getPendingBytes() < 2 + 6 * 6);
+    framebuffer.flush();
+}
+
+SCENARIO(frame_scheduler, 762) {
+    Nokia_LCD_Framebuffer framebuffer(lcd);
+    FrameScheduler scheduler(framebuffer, 50);
+    framebuffer.clear(true);
+    EXPECT(scheduler.update());
+    // Too soon for the next frame
+    framebuffer.setCursor(0, 0);
+    framebuffer.print("scheduled");
+    EXPECT(!scheduler.update());
+    delay(20);
+    EXPECT(scheduler.update());
+    EXPECT(scheduler.getFrameMicros() > 0);
+    // With a budget the frame is sent over several updates
+    scheduler.setMaxRate(0);
+    scheduler.setBudget(200);
+    for (uint8_t page = 1; page < 6; page++) {
+        framebuffer.setCursor(0, page);
+        framebuffer.print("budget");
+    }
+    EXPECT(scheduler.update());
+    EXPECT(scheduler.getDeferredBytes() > 0);
+    EXPECT(scheduler.getByteMicros() > 0);
+    while (scheduler.update()) {
+    }
+    EXPECT(scheduler.getDeferredBytes() == 0);
+    delay(1000);
+    scheduler.update();
+    EXPECT(scheduler.getFps() > 0);
+}
+
+SCENARIO(widgets, 2213) {
+    WidgetScreen screen(lcd);
+    Label title({0, 0, 84, 8}, "Widgets", nokia_lcd::Alignment::kCenter);
+    NumberLabel temperature({0, 8, 40, 8}, 1);
+    Icon bell({76, 8, 7, 8}, kBell);
+    Icon smiley({60, 8, 8, 8}, kSmiley, false);
+    ProgressBar progress({0, 18, 84, 6}, 200);
+    ListView menu({0, 24, 60, 24}, kMenu, 6);
+    ModalBox modal({10, 12, 64, 24}, "Saved!");
+    screen.add(title);
+    screen.add(temperature);
+    screen.add(bell);
+    screen.add(smiley);
+    screen.add(progress);
+    screen.add(menu);
+    screen.add(modal, 1);
+    modal.setVisible(false);
+    temperature.setValue(-215);
+    progress.setValue(50);
+    EXPECT(screen.update());
+    EXPECT(!screen.update());
+
+    // Only what changed is sent
+    const unsigned long before = display.getBusBytes();
+    progress.setValue(60);
+    EXPECT(screen.update());
+    EXPECT(display.getBusBytes() - before < 20);
+    temperature.setValue(-215);
+    EXPECT(!screen.update());
+
+    EXPECT(!menu.setSelected(4));
+    EXPECT(menu.getSelected() == 4);
+    EXPECT(menu.setSelected(6));
+    title.setText("Menu");
+    bell.setVisible(false);
+    EXPECT(!bell.isVisible());
+    screen.update();
+
+    // The box covers what is beneath it until it is hidden again
+    modal.setVisible(true);
+    screen.update();
+    modal.setVisible(false);
+    screen.remove(smiley);
+    screen.update();
+    modal.setVisible(true);
+    screen.update();
+    EXPECT(modal.getBounds().width == 64);
+
+    // Drawn over behind the screen's back, then repaired
+    lcd.setCursor(0, 5);
+    lcd.print("garbage");
+    screen.damage({0, 40, 42, 8});
+    screen.update();
+    lcd.setCursor(60, 4);
+    lcd.print("xx");
+    screen.invalidate();
+    screen.update();
+}
+
+SCENARIO(chart_scroll, 20336) {
+    int16_t samples[60];
+    Nokia_LCD_Chart chart(lcd, samples, 60, 12, 1, 4);
+    for (int16_t i = 0; i < 80; i++) {
+        EXPECT(!chart.add((i * 37) % 50 - 10));
+    }
+    EXPECT(chart.getMin() <= -10 && chart.getMax() >= 39);
+    chart.setRange(0, 20);
+    EXPECT(chart.getMin() == 0 && chart.getMax() == 20);
+    EXPECT(!chart.add(25));
+    EXPECT(!chart.redraw());
+}
+
+SCENARIO(chart_sweep, 2318) {
+    int16_t samples[40];
+    Nokia_LCD_Chart chart(lcd, samples, 40, 0, 0, 3);
+    chart.setMode(nokia_lcd::ChartMode::kSweep);
+    for (int16_t i = 0; i < 50; i++) {
+        chart.add(i % 10);
+    }
+    // A new sample only sends its column and the gap after it
+    const unsigned long before = display.getBusBytes();
+    chart.add(5);
+    EXPECT(display.getBusBytes() - before < 20);
+    // The 52nd sample goes to column 11 and the gap after it stays blank,
+    // as the inversion of the display does not apply to the chart
+    lcd.setInverted(true);
+    chart.add(6);
+    lcd.setInverted(false);
+    for (uint8_t y = 0; y < 24; y++) {
+        EXPECT(!display.getPixel(12, y));
+    }
+    chart.setAutoscale();
+    chart.add(100);
+
+    // A chart that does not fit is cut at the edge of the screen
+    int16_t cut_samples[30];
+    Nokia_LCD_Chart cut(lcd, cut_samples, 30, 70, 4, 4);
+    for (int16_t i = 0; i < 30; i++) {
+        cut.add(i);
+    }
+    cut.clear();
+    cut.add(3);
+}
+
+SCENARIO(display_group, 613) {
+    // Two more displays on their own chip select pins
+    const uint8_t ce_pins[] = {test::kCe_pin, 6, 5};
+    digitalWrite(ce_pins[1], HIGH);
+    digitalWrite(ce_pins[2], HIGH);
+    Pcd8544 second(test::kDc_pin, ce_pins[1], test::kRst_pin);
+    Pcd8544 third(test::kDc_pin, ce_pins[2], test::kRst_pin);
+    DisplayGroup group(lcd, ce_pins, 3);
+    group.begin();
+    EXPECT(group.size() == 3);
+    group.setContrast(0x38);
+    group.clear();
+
+    group.beginBroadcast().print("Group");
+    group.end();
+    EXPECT(!group.beginDisplay(0));
+    lcd.print(" 0");
+    group.end();
+    EXPECT(!group.beginDisplay(1));
+    lcd.print(" 1");
+    group.end();
+    // Each display goes on where it was left
+    EXPECT(!group.beginDisplay(0));
+    lcd.print(" again");
+    group.end();
+    EXPECT(!group.beginDisplay(2));
+    lcd.println();
+    group.end();
+    group.beginBroadcast().print("all");
+    group.end();
+    // There is no fourth display, so none of them listens
+    EXPECT(group.beginDisplay(3));
+    EXPECT(digitalRead(ce_pins[0]) == HIGH && digitalRead(ce_pins[1]) == HIGH &&
+           digitalRead(ce_pins[2]) == HIGH);
+    lcd.print("nowhere");
+    group.end();
+
+    EXPECT(second.getErrors() == 0 && third.getErrors() == 0);
+    EXPECT(second.toPbm().find("contrast 56") != std::string::npos);
+    bool second_differs = false;
+    for (uint8_t x = 0; x < 84; x++) {
+        // The header is the same on all of them
+        for (uint8_t y = 0; y < 8 && x < 30; y++) {
+            EXPECT(second.getPixel(x, y) == display.getPixel(x, y));
+            EXPECT(third.getPixel(x, y) == display.getPixel(x, y));
+        }
+        for (uint8_t y = 0; y < 8; y++) {
+            second_differs =
+                second_differs || second.getPixel(x, y) != display.getPixel(x, y);
+        }
+        // "all" went to the second row of the third display only
+        for (uint8_t y = 8; y < 16; y++) {
+            EXPECT(!second.getPixel(x, y));
+        }
+    }
+    EXPECT(second_differs);
+}
+
+SCENARIO(dither, 506) {
+    Nokia_LCD_Dither dither(lcd);
+    EXPECT(!dither.drawOrdered(readGradient, 84, 24));
+    EXPECT(lcd.setCursor(0, 3));
+    // Ending at the bottom right corner wraps the cursor back to the top
+    EXPECT(dither.drawDiffused(readGradient, 84, 24));
+}
+
+SCENARIO(gray, 1548) {
+    Nokia_LCD_Gray gray(lcd);
+    gray.fill(0);
+    for (uint8_t x = 0; x < 84; x++) {
+        for (uint8_t y = 16; y < 32; y++) {
+            gray.setPixel(x, y, x / 21);
+        }
+        gray.setPixel(x, 40, 3);
+    }
+    EXPECT(gray.setPixel(84, 0, 3));
+    EXPECT(gray.getPixel(30, 20) == 1);
+    EXPECT(gray.getPixel(83, 40) == 3);
+    // Longer than sending a phase takes, so that the phases are paced
+    gray.setPhaseInterval(5000);
+    for (int i = 0; i < 7; i++) {
+        while (!gray.update()) {
+            delayMicroseconds(100);
+        }
+    }
+    EXPECT(!gray.update());
+    EXPECT(gray.getCycleMicros() >= 3 * 5000);
+    EXPECT(gray.getRefreshRate() > 0);
+}
+
+SCENARIO(queue, 76) {
+    Nokia_LCD_Queue queue(lcd);
+    EXPECT(queue.setCursor(10, 2));
+    for (const char *c = "queued"; *c; c++) {
+        EXPECT(queue.print(*c));
+    }
+    EXPECT(queue.draw(kBell, sizeof(kBell), 7));
+    EXPECT(queue.fill(0x18, 5));
+    const nokia_lcd::DrawOperation operation{
+        nokia_lcd::DrawOperation::kSet_cursor, 0, 4, nullptr};
+    EXPECT(queue.post(operation));
+    EXPECT(queue.print('!'));
+    EXPECT(queue.service() == 11);
+    EXPECT(queue.service() == 0);
+
+    // A full queue refuses more operations
+    uint8_t queued = 0;
+    while (queue.fill(0x81, 1)) {
+        queued++;
+    }
+    EXPECT(queued == nokia_lcd::kQueue_capacity);
+    EXPECT(queue.service() == nokia_lcd::kQueue_capacity);
+}
@@ -0,0 +1,258 @@
+// Scenarios of drawing bitmaps, sending raw bytes and the display settings
+#include <Nokia_LCD_Rle.h>
+
+#include <vector>
+
+#include "scenario.h"
+
+namespace {
+const unsigned char kArrow[] PROGMEM = {0x08, 0x1C, 0x3E, 0x7F, 0x1C, 0x1C,
+                                        0x1C, 0x1C};
+const unsigned char kChecker[] = {0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA,
+                                  0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA};
+
+// A bitmap 12 columns wide and 2 rows tall, read from memory
+class BufferStream : public Stream {
+public:
+    BufferStream(const unsigned char *data, unsigned int size)
+        : mData{data}, mSize{size}, mPosition{0} {}
+    int available() override { return mSize - mPosition; }
+    int read() override {
+        return mPosition < mSize ? mData[mPosition++] : -1;
+    }
+    int peek() override { return mPosition < mSize ? mData[mPosition] : -1; }
+    size_t write(uint8_t) override { return 0; }
+
+private:
+    const unsigned char *mData;
+    unsigned int mSize;
+    unsigned int mPosition;
+};
+
+unsigned int gStream_position = 0;
+
+unsigned int readRamp(unsigned char buffer[], unsigned int size) {
+    // A ramp 40 columns wide and one row tall, in chunks of 5 bytes
+    unsigned int count = 0;
+    while (count < size && count < 5 && gStream_position < 40) {
+        buffer[count++] = 0xFF >> (7 - gStream_position++ % 8);
+    }
+    return count;
+}
+
+// 5 times 0x81, then 0x01 0x02 0x04, then 6 times 0xFF
+const unsigned char kRle_bitmap[] PROGMEM = {0x83, 0x81, 0x02, 0x01, 0x02,
+                                             0x04, 0x84, 0xFF};
+}  // namespace
+
+SCENARIO(draw_bitmaps, 68) {
+    // Read from flash and from RAM, as wide as the screen and narrower
+    EXPECT(!lcd.draw(kArrow, sizeof(kArrow)));
+    EXPECT(lcd.setCursor(20, 0));
+    EXPECT(!lcd.draw(kChecker, sizeof(kChecker), false, 6));
+    EXPECT(lcd.getCursorX() == 20 && lcd.getCursorY() == 2);
+    // A narrow bitmap wraps at its own left edge
+    EXPECT(lcd.setCursor(40, 2));
+    EXPECT(!lcd.draw(kArrow, sizeof(kArrow), true, 4));
+    // A wide one at the edge of the screen continues on the next row
+    EXPECT(lcd.setCursor(80, 3));
+    EXPECT(!lcd.draw(kChecker, sizeof(kChecker), false));
+    EXPECT(lcd.getCursorX() == 8 && lcd.getCursorY() == 4);
+    // Past the end of the screen it goes on from the top
+    EXPECT(lcd.setCursor(78, 5));
+    EXPECT(lcd.draw(kChecker, sizeof(kChecker), false));
+    EXPECT(lcd.getCursorY() == 0);
+}
+
+SCENARIO(draw_columns, 142) {
+    // A bar graph, each column 3 rows tall from top to bottom
+    unsigned char bars[3 * 30];
+    for (unsigned int column = 0; column < 30; column++) {
+        const unsigned int height = column % 24;
+        for (unsigned int page = 0; page < 3; page++) {
+            const int bits = static_cast<int>(height) - 8 * (2 - page);
+            bars[3 * column + page] =
+                bits <= 0 ? 0x00 : bits >= 8 ? 0xFF : 0xFF << (8 - bits);
+        }
+    }
+    EXPECT(lcd.setCursor(10, 2));
+    // Bytes that do not make up a whole column are refused
+    EXPECT(lcd.drawColumns(bars, sizeof(bars) - 1, 3, false));
+    EXPECT(lcd.getCursorX() == 10 && lcd.getCursorY() == 2);
+    EXPECT(!lcd.drawColumns(bars, sizeof(bars), 3, false));
+    // A single row is drawn as it is
+    EXPECT(lcd.setCursor(50, 0));
+    EXPECT(!lcd.drawColumns(kArrow, sizeof(kArrow), 1));
+    // Printing afterwards still goes from left to right
+    EXPECT(lcd.setCursor(50, 1));
+    EXPECT(!lcd.print("after"));
+}
+
+SCENARIO(draw_stream, 139) {
+    unsigned char bitmap[24];
+    for (unsigned int i = 0; i < sizeof(bitmap); i++) {
+        bitmap[i] = i < 12 ? 0x0F << (i % 5) : 0xF0 >> (i % 5);
+    }
+    BufferStream stream(bitmap, sizeof(bitmap));
+    EXPECT(lcd.setCursor(4, 1));
+    EXPECT(!lcd.drawStream(stream, 12, 16));
+
+    gStream_position = 0;
+    EXPECT(lcd.setCursor(30, 1));
+    EXPECT(!lcd.drawStream(readRamp, 40, 8));
+
+    std::vector<unsigned char> wave;
+    for (unsigned int i = 0; i < 84; i++) {
+        wave.push_back(1 << (i % 14 < 7 ? i % 14 : 13 - i % 14));
+    }
+    EXPECT(lcd.setCursor(0, 4));
+    EXPECT(!lcd.drawStream(wave.begin(), wave.end(), 84));
+
+    // Runs of bytes decoded while they are drawn
+    EXPECT(lcd.setCursor(30, 5));
+    EXPECT(!lcd.drawStream(RleIterator(kRle_bitmap),
+                           RleIterator(kRle_bitmap + sizeof(kRle_bitmap)),
+                           84));
+}
+
+SCENARIO(clear, 702) {
+    lcd.print("gone");
+    lcd.clear(true);
+    EXPECT(lcd.getCursorX() == 0 && lcd.getCursorY() == 0);
+    lcd.setInverted(true);
+    lcd.print("white on black");
+    lcd.setInverted(false);
+    lcd.setCursor(0, 5);
+    lcd.print("black on white");
+}
+
+SCENARIO(cursor, 13) {
+    EXPECT(lcd.setCursor(83, 5));
+    EXPECT(lcd.getCursorX() == 83 && lcd.getCursorY() == 5);
+    // Invalid positions are refused and the cursor stays
+    EXPECT(!lcd.setCursor(84, 0));
+    EXPECT(!lcd.setCursor(0, 6));
+    EXPECT(lcd.getCursorX() == 83 && lcd.getCursorY() == 5);
+    // Every byte moves the cursor the way the display does
+    EXPECT(lcd.sendData(0xFF));
+    EXPECT(lcd.getCursorX() == 0 && lcd.getCursorY() == 0);
+    EXPECT(!lcd.sendData(0x81));
+    EXPECT(lcd.getCursorX() == 1 && lcd.getCursorY() == 0);
+    EXPECT(lcd.setCursor(83, 2));
+    EXPECT(!lcd.sendData(0x3C));
+    EXPECT(lcd.getCursorX() == 0 && lcd.getCursorY() == 3);
+    EXPECT(!lcd.print("x"));
+}
+
+SCENARIO(commands, 68) {
+    // Inverse video through raw commands, then back to normal in one batch
+    lcd.print("commands");
+    lcd.sendCommand(0x0D);
+    const unsigned char normal[] = {0x20, 0x0C, 0x40 | 2, 0x80 | 10};
+    lcd.sendCommands(normal, sizeof(normal));
+    // The commands moved the display's cursor behind the library's back
+    lcd.sendData(0xFF);
+    lcd.setCursor(0, 1);
+    lcd.print("ok");
+}
+
+SCENARIO(settings, 138) {
+    lcd.setContrast(0x3C);
+    lcd.setBias(3);
+    lcd.setTemperatureCoefficient(2);
+    lcd.print("settings");
+    // Kept while asleep and restored on waking up
+    lcd.sleep();
+    lcd.setCursor(0, 1);
+    lcd.print("asleep");
+    lcd.wake();
+    lcd.print(" awake");
+}
+
+SCENARIO(sleeping, 78) {
+    lcd.print("asleep");
+    lcd.sleep();
+    EXPECT(display.isPoweredDown());
+    // Neither extended instructions nor another addressing mode wake it up
+    lcd.setContrast(0x40);
+    EXPECT(display.isPoweredDown());
+    const unsigned char column[] = {0xFF, 0x81};
+    EXPECT(lcd.setCursor(0, 2));
+    EXPECT(!lcd.drawColumns(column, sizeof(column), 2));
+    EXPECT(display.isPoweredDown());
+    lcd.print("still");
+    EXPECT(display.isPoweredDown());
+}
+
+SCENARIO(init_profile, 48) {
+    const nokia_lcd::InitProfile profile{0x45, 0x03, 0x01};
+    lcd.begin(profile);
+    lcd.print("profile");
+}
+
+SCENARIO(constructors, 276) {
+    // The same display, driven by every kind of instance in turn
+    lcd.print("software");
+    Nokia_LCD backlit(test::kClk_pin, test::kDin_pin, test::kDc_pin,
+                      test::kCe_pin, test::kRst_pin, test::kBl_pin);
+    backlit.begin();
+    backlit.setBacklight(true);
+    EXPECT(digitalRead(test::kBl_pin) == HIGH);
+    backlit.setCursor(0, 1);
+    backlit.print("backlight");
+    backlit.setBacklight(false);
+    EXPECT(digitalRead(test::kBl_pin) == LOW);
+    // Without a backlight pin nothing happens
+    lcd.setBacklight(true);
+
+    Nokia_LCD hardware(test::kDc_pin, test::kCe_pin, test::kRst_pin);
+    hardware.begin();
+    hardware.setCursor(0, 2);
+    hardware.print("hardware SPI");
+    Nokia_LCD hardware_backlit(test::kDc_pin, test::kCe_pin, test::kRst_pin,
+                               test::kBl_pin);
+    hardware_backlit.begin();
+    hardware_backlit.setBacklight(true);
+    EXPECT(digitalRead(test::kBl_pin) == HIGH);
+    hardware_backlit.setCursor(0, 3);
+    hardware_backlit.print("and backlight");
+}
+
+SCENARIO(transfers, 42) {
+    // Nested transfers keep the display selected until the outermost ends
+    lcd.beginTransfer();
+    lcd.print("one");
+    lcd.beginTransfer();
+    lcd.print(2);
+    EXPECT(digitalRead(test::kCe_pin) == LOW);
+    lcd.endTransfer();
+    EXPECT(digitalRead(test::kCe_pin) == LOW);
+    lcd.print(3.0, 1);
+    lcd.endTransfer();
+    EXPECT(digitalRead(test::kCe_pin) == HIGH);
+}
+
+SCENARIO(couple, 66) {
+    // A second display sharing all pins but CE follows while coupled
+    const uint8_t second_ce_pin = 7;
+    digitalWrite(second_ce_pin, HIGH);
+    Pcd8544 second(test::kDc_pin, second_ce_pin, test::kRst_pin);
+    Nokia_LCD second_lcd(test::kClk_pin, test::kDin_pin, test::kDc_pin,
+                         second_ce_pin, test::kRst_pin);
+    second_lcd.couple();
+    lcd.begin();
+    lcd.print("both");
+    second_lcd.uncouple();
+    lcd.print(" first");
+    EXPECT(second.toPbm().find("power on") != std::string::npos);
+    for (uint8_t x = 0; x < 24; x++) {
+        for (uint8_t y = 0; y < 8; y++) {
+            EXPECT(second.getPixel(x, y) == display.getPixel(x, y));
+        }
+    }
+    for (uint8_t x = 24; x < 84; x++) {
+        for (uint8_t y = 0; y < 8; y++) {
+            EXPECT(!second.getPixel(x, y));
+        }
+    }
+}
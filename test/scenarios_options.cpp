@@ -0,0 +1,114 @@
+// Scenarios of the optional parts of Nokia_LCD, built into a test of their
+// own with NOKIA_LCD_ENABLE_STATS, NOKIA_LCD_ENABLE_TRACE,
+// NOKIA_LCD_ENABLE_ROTATION and STRING_CLASS_IS_IMPLEMENTED defined
+#include <string>
+
+#include "scenario.h"
+
+namespace {
+// Keeps what is printed, e.g. instead of `Serial`
+class Capture : public Print {
+public:
+    size_t write(uint8_t byte) override {
+        text += static_cast<char>(byte);
+        return 1;
+    }
+    std::string text;
+};
+}  // namespace
+
+SCENARIO(stats, 30) {
+    lcd.resetStats();
+    const unsigned long before = display.getBusBytes();
+    lcd.print("stats");
+    const nokia_lcd::Stats &stats = lcd.getStats();
+    EXPECT(stats.glyphs == 5);
+    EXPECT(stats.data_bytes == 5 * 6);
+    EXPECT(stats.commands + stats.data_bytes ==
+           display.getBusBytes() - before);
+    EXPECT(stats.transfers >= 1);
+    EXPECT(stats.send_micros > 0);
+    Capture output;
+    lcd.printStats(output);
+    EXPECT(output.text.find("glyphs: 5\r\n") != std::string::npos);
+    EXPECT(output.text.find("data bytes: 30\r\n") != std::string::npos);
+    lcd.resetStats();
+    EXPECT(lcd.getStats().glyphs == 0);
+}
+
+SCENARIO(trace, 1268) {
+    lcd.clearTrace();
+    lcd.setCursor(5, 1);
+    lcd.print("t");
+    Capture output;
+    lcd.exportTrace(output);
+    const std::string &trace = output.text;
+    EXPECT(trace.compare(0, 5, "NLTR\x01") == 0);
+    const unsigned int entries =
+        static_cast<uint8_t>(trace[5]) | static_cast<uint8_t>(trace[6]) << 8;
+    EXPECT(trace.size() == 9 + 2 * entries);
+    EXPECT(trace[7] == 0 && trace[8] == 0);
+    // The last entries are the glyph, its spacing and releasing CE
+    EXPECT(trace[trace.size() - 2] == nokia_lcd::kTrace_ce);
+    EXPECT(trace[trace.size() - 1] == HIGH);
+    EXPECT(trace[trace.size() - 4] == nokia_lcd::kTrace_data);
+    // Older entries are dropped when the trace is full
+    for (int i = 0; i < 10; i++) {
+        lcd.print("overflowing the trace");
+    }
+    Capture full;
+    lcd.exportTrace(full);
+    EXPECT(full.text.size() == 9 + 2 * nokia_lcd::kTrace_capacity);
+    EXPECT(full.text[7] != 0 || full.text[8] != 0);
+}
+
+SCENARIO(rotation, 294) {
+    lcd.setRotation(nokia_lcd::Rotation::k180);
+    EXPECT(lcd.getWidth() == 84 && lcd.getHeight() == 48);
+    lcd.print("upside down");
+    lcd.setRotation(nokia_lcd::Rotation::k90);
+    EXPECT(lcd.getWidth() == 48 && lcd.getHeight() == 80);
+    lcd.setCursor(0, 0);
+    lcd.print("portrait");
+    lcd.setRotation(nokia_lcd::Rotation::k270, true);
+    lcd.setCursor(0, 0);
+    lcd.print("mirror");
+    lcd.setRotation(nokia_lcd::Rotation::k0, true);
+    lcd.setCursor(0, 2);
+    lcd.print("mirrored");
+    lcd.setRotation(nokia_lcd::Rotation::k0);
+    lcd.setCursor(30, 3);
+    lcd.print("normal");
+}
+
+SCENARIO(rotation_partial_blocks, 66) {
+    // Portrait blocks of 8 columns are only partly drawn on, but keep what
+    // the display showed in their other columns
+    lcd.setCursor(60, 0);
+    lcd.print("edge");
+    uint8_t edge_pixels = 0;
+    for (uint8_t x = 76; x < 84; x++) {
+        edge_pixels += display.getPixel(x, 6);
+    }
+    lcd.setRotation(nokia_lcd::Rotation::k90);
+    lcd.print("A");
+    lcd.setCursor(12, 0);
+    lcd.print("C");
+    // Back to the block of the last column of "C"
+    lcd.setCursor(18, 0);
+    lcd.print("B");
+    uint8_t kept_pixels = 0;
+    bool last_column_kept = false;
+    for (uint8_t x = 76; x < 84; x++) {
+        kept_pixels += display.getPixel(x, 6);
+        last_column_kept = last_column_kept || display.getPixel(x, 16);
+    }
+    EXPECT(edge_pixels > 0 && kept_pixels == edge_pixels);
+    EXPECT(last_column_kept);
+}
+
+SCENARIO(string_class, 98) {
+    const String string("Arduino String");
+    EXPECT(!lcd.println(string));
+    EXPECT(!lcd.print(String("\xC2\xB0" "C")));
+}
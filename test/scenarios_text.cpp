@@ -0,0 +1,275 @@
+// Scenarios of printing text and numbers
+#include <stdint.h>
+
+#include "fonts/Digits_LCD_Fonts.h"
+#include "fonts/Narrow_LCD_Fonts.h"
+#include "Bold_LCD_Fonts.h"
+#include "Glyphs_LCD_Fonts.h"
+#include "Small_LCD_Fonts.h"
+#include "scenario.h"
+
+namespace {
+// As in the font example
+const LcdFont BoldFont{
+    [](char c) { return Bold_LCD_Fonts::kFont_Table[c - 0x20]; },
+    Bold_LCD_Fonts::kColumns_per_character, Bold_LCD_Fonts::hSpace, 1};
+
+class Temperature : public Printable {
+public:
+    size_t printTo(Print &p) const override {
+        return p.print(-12) + p.print(F(" C"));
+    }
+};
+}  // namespace
+
+SCENARIO(print_strings, 232) {
+    EXPECT(!lcd.print("Hello world!"));
+    EXPECT(lcd.getCursorX() == 72 && lcd.getCursorY() == 0);
+    EXPECT(!lcd.println(" ok"));
+    EXPECT(lcd.getCursorX() == 0 && lcd.getCursorY() == 2);
+    EXPECT(!lcd.print('c'));
+    EXPECT(!lcd.println('d'));
+    EXPECT(!lcd.print(F("flash ")));
+    EXPECT(!lcd.println(F("text")));
+    EXPECT(!lcd.println());
+    EXPECT(lcd.print(Temperature()) == 5);
+    EXPECT(lcd.println(Temperature()) == 6);
+}
+
+SCENARIO(print_integers, 304) {
+    // Kept to 32 bits, as long is on the boards, and within a row each
+    EXPECT(!lcd.print(0));
+    lcd.print(' ');
+    EXPECT(!lcd.println(-7));
+    EXPECT(!lcd.println(INT32_MIN));
+    EXPECT(!lcd.print(0U));
+    lcd.print(' ');
+    EXPECT(!lcd.println(UINT32_MAX));
+    EXPECT(!lcd.println(static_cast<long>(INT32_MAX)));
+    EXPECT(!lcd.println(4294967295UL));
+    EXPECT(!lcd.print(-1L));
+}
+
+SCENARIO(print_decimals, 442) {
+    // Rounded, not truncated, and the sign is kept between -1 and 0. Numbers
+    // that do not fit in an unsigned long are printed like Print does it
+    EXPECT(!lcd.print(1.15, 1));
+    lcd.print(' ');
+    EXPECT(!lcd.print(-0.5));
+    lcd.print(' ');
+    EXPECT(!lcd.println(-INFINITY));
+    EXPECT(!lcd.print(-1.05, 1));
+    lcd.print(' ');
+    EXPECT(!lcd.print(NAN));
+    lcd.print(' ');
+    EXPECT(!lcd.println(5e9));
+    EXPECT(!lcd.print(3.14159, 4));
+    lcd.print(' ');
+    EXPECT(!lcd.println(99.999));
+    EXPECT(!lcd.print(0.0));
+    lcd.print(' ');
+    EXPECT(!lcd.print(-0.004));
+    lcd.print(' ');
+    EXPECT(!lcd.println(2.5, 0));
+    // At most 9 decimals
+    EXPECT(!lcd.println(0.5, 12));
+    EXPECT(!lcd.print(-123456.789, 3));
+}
+
+SCENARIO(print_bases, 212) {
+    // The bases of Print, with its uppercase digits
+    EXPECT(!lcd.print(255, HEX));
+    lcd.print(' ');
+    EXPECT(!lcd.print(5, BIN));
+    lcd.print(' ');
+    EXPECT(!lcd.println(8UL, OCT));
+    // Only decimal numbers are signed
+    EXPECT(!lcd.print(-42, DEC));
+    lcd.print(' ');
+    EXPECT(!lcd.print(static_cast<unsigned char>(200)));
+    lcd.print(' ');
+    EXPECT(!lcd.println(static_cast<unsigned int>(0xBEEF), HEX));
+    EXPECT(!lcd.println(F("flash")));
+    // Without STRING_CLASS_IS_IMPLEMENTED the String overload of Print prints
+    // through write()
+    EXPECT(lcd.print(String("String")) == 6);
+    // Through the interface of Print, the same
+    Print &print = lcd;
+    print.println();
+    EXPECT(print.print(0xAB, HEX) == 2);
+}
+
+SCENARIO(print_wraps_to_next_row, 112) {
+    // Text started at any column wraps to the beginning of the next row
+    EXPECT(lcd.setCursor(50, 1));
+    EXPECT(!lcd.print("wrapping text"));
+    EXPECT(lcd.getCursorY() == 2);
+    EXPECT(lcd.getCursorX() == 13 * 6 - (84 - 50));
+    // The first wrapped glyph is drawn at the left edge
+    bool first_glyph_drawn = false;
+    for (uint8_t x = 0; x < 6; x++) {
+        for (uint8_t y = 16; y < 24; y++) {
+            first_glyph_drawn = first_glyph_drawn || display.getPixel(x, y);
+        }
+    }
+    EXPECT(first_glyph_drawn);
+    // Nothing is drawn left of where the text started on its own row
+    for (uint8_t x = 0; x < 50; x++) {
+        for (uint8_t y = 8; y < 16; y++) {
+            EXPECT(!display.getPixel(x, y));
+        }
+    }
+
+    // Past the end of the screen it goes on from the top, which is reported
+    EXPECT(lcd.setCursor(78, 5));
+    EXPECT(lcd.print("end!"));
+    EXPECT(lcd.getCursorY() == 0);
+    EXPECT(lcd.setCursor(0, 4));
+    EXPECT(!lcd.print("\n"));
+    EXPECT(lcd.print("\n"));
+    EXPECT(lcd.getCursorX() == 0 && lcd.getCursorY() == 0);
+}
+
+SCENARIO(print_aligned, 192) {
+    EXPECT(!lcd.print("left", 0, nokia_lcd::Alignment::kLeft));
+    lcd.setCursor(0, 1);
+    EXPECT(!lcd.print("center", 42, nokia_lcd::Alignment::kCenter));
+    lcd.setCursor(0, 2);
+    // Ending at the right edge wraps the cursor to the next row
+    EXPECT(!lcd.println("right", 84, nokia_lcd::Alignment::kRight));
+    EXPECT(lcd.getCursorX() == 0 && lcd.getCursorY() == 4);
+    // Text that would start left of the screen is cut at its edge
+    lcd.setCursor(0, 3);
+    EXPECT(lcd.print("from the left", 30, nokia_lcd::Alignment::kRight));
+    lcd.setCursor(0, 4);
+    EXPECT(!lcd.print("a\nb", 20, nokia_lcd::Alignment::kCenter));
+    // Text is cut at the right edge instead of wrapping
+    EXPECT(lcd.print("cut at right", 50, nokia_lcd::Alignment::kLeft));
+}
+
+SCENARIO(print_in_box, 924) {
+    lcd.clear(true);
+    EXPECT(!lcd.printInBox(2, 0, 80, 3, "Words wrap inside the box"));
+    EXPECT(!lcd.printInBox(0, 3, 84, 1, "centered",
+                           nokia_lcd::Alignment::kCenter));
+    EXPECT(lcd.printInBox(10, 4, 40, 2,
+                          "This text is far too long for the box",
+                          nokia_lcd::Alignment::kRight));
+}
+
+SCENARIO(printf_format, 526) {
+    EXPECT(!lcd.printf("%02d:%02d %5s|", 7, 5, "ok"));
+    lcd.setCursor(0, 1);
+    EXPECT(!lcd.printf("%-4d|%04x|%lu", -12, 0xbeef, 4000000000UL));
+    lcd.setCursor(0, 2);
+    EXPECT(!lcd.printf("%.1f %f %c%%", -0.05, 2.0 / 3, 'Z'));
+    lcd.setCursor(0, 3);
+    EXPECT(!lcd.printf(F("%ld %u"), -2147483647L - 1, 65535U));
+    lcd.setCursor(0, 4);
+    EXPECT(!lcd.printf("%6.2f|%-6s|", 3.14159, "ab"));
+    lcd.setCursor(0, 5);
+    EXPECT(!lcd.printf("%05f|%.12f|%.0f", NAN, -1e10, 7.5));
+}
+
+SCENARIO(print_write, 74) {
+    EXPECT(lcd.write('w') == 1);
+    const uint8_t buffer[] = {'b', 'u', 'f', 'f', 'e', 'r'};
+    EXPECT(lcd.write(buffer, sizeof(buffer)) == sizeof(buffer));
+    EXPECT(lcd.write("\r\nPrint") == 7);
+    EXPECT(lcd.getCursorY() == 1);
+}
+
+SCENARIO(print_utf8, 164) {
+    EXPECT(!lcd.println("21\xC2\xB0" "C 5\xC2\xB5s"));
+    EXPECT(!lcd.println("\xC3\xA4\xC3\xB6\xC3\xBC \xC3\x9F \xE2\x82\xAC"));
+    // Written one byte at a time
+    const char *omega = "\xCE\xA9";
+    EXPECT(!lcd.print(omega[0]));
+    EXPECT(!lcd.println(omega[1]));
+    // Missing code points, broken sequences and control characters are shown
+    // with the fallback glyph
+    EXPECT(!lcd.println("\xE2\x98\x83|\x80|\xC3|\t|\x01|\x7F"));
+}
+
+SCENARIO(measure_text, 48) {
+    constexpr nokia_lcd::TextSize size = nokia_lcd::measureText("Menu\nA");
+    static_assert(size.width == 23 && size.lines == 2,
+                  "Measured at compile time");
+    EXPECT(nokia_lcd::measureText("\xC2\xB0" "C").width == 11);
+    const nokia_lcd::TextSize small =
+        nokia_lcd::measureText("abc", &Small_LCD_Fonts::SmallFont);
+    EXPECT(small.width == 11 && small.lines == 1);
+    const nokia_lcd::TextSize narrow =
+        nokia_lcd::measureText("1 i\nW", &Narrow_LCD_Fonts::NarrowFont);
+    EXPECT(narrow.lines == 2);
+    // The text is framed by what was measured
+    const nokia_lcd::TextSize text = nokia_lcd::measureText("framed");
+    lcd.setCursor(10, 2);
+    lcd.print("framed");
+    const unsigned char edge[] = {0xFF};
+    lcd.setCursor(9, 2);
+    lcd.draw(edge, 1, false, 1);
+    lcd.setCursor(10 + text.width, 2);
+    lcd.draw(edge, 1, false, 1);
+}
+
+SCENARIO(fonts_examples, 452) {
+    // The font example, toolbar and pattern
+    lcd.setFont(&Glyphs_LCD_Fonts::GlyphFont);
+    EXPECT(lcd.getFont() == &Glyphs_LCD_Fonts::GlyphFont);
+    const unsigned char toolbar[] = {0x0E, 0x0F, 0x1D, 0xF9, 0x20, 0x1A, 0x20,
+                                     0x1B, 0x20, 0x19, 0x20, 0x01, 0x02, 0x03};
+    for (unsigned char glyph : toolbar) {
+        lcd.print(static_cast<char>(glyph));
+    }
+    lcd.setCursor(0, 1);
+    for (int i = 0; i < 14; i++) {
+        lcd.print(static_cast<char>(0xD4 + i / 5));
+    }
+    lcd.setCursor(0, 2);
+    lcd.setFont(&Small_LCD_Fonts::SmallFont);
+    lcd.print("This is an example\nof small font, it\nuses 3px width");
+    lcd.setCursor(0, 5);
+    lcd.setFont(&BoldFont);
+    lcd.print("I'M BOLD!");
+    lcd.setFont(nullptr);
+    EXPECT(lcd.getFont() == &BoldFont);
+    lcd.setDefaultFont();
+    lcd.print("x");
+}
+
+SCENARIO(fonts_converted, 452) {
+    lcd.setFont(&Narrow_LCD_Fonts::NarrowFont);
+    lcd.println("Proportional: il1 WM");
+    lcd.setFont(&Digits_LCD_Fonts::DigitsFont);
+    lcd.println("12:34.5-6");
+    // Missing from the packed font, so drawn with its fallback glyph
+    lcd.println("7a8\xC2\xB0");
+    lcd.print(-3.25);
+    lcd.print(':');
+    lcd.print(1234567890UL);
+    lcd.setCursor(0, 4);
+    lcd.printf("%05d", 42);
+    lcd.setFont(&Narrow_LCD_Fonts::NarrowFont);
+    lcd.print("wraps at the right edge");
+}
+
+SCENARIO(inverted, 346) {
+    lcd.setInverted(true);
+    lcd.print("Inverted text");
+    lcd.setCursor(0, 1);
+    lcd.print(-1.5);
+    lcd.printf(" %d", 10);
+    const unsigned char bitmap[] = {0x01, 0x03, 0x07, 0x0F, 0x1F, 0x3F};
+    lcd.setCursor(0, 2);
+    lcd.draw(bitmap, sizeof(bitmap), false);
+    lcd.setCursor(0, 3);
+    lcd.printInBox(0, 3, 84, 2, "In a box, inverted",
+                   nokia_lcd::Alignment::kCenter);
+    lcd.setFont(&Small_LCD_Fonts::SmallFont);
+    lcd.setCursor(70, 5);
+    lcd.print("wrap");
+    lcd.setInverted(false);
+    lcd.setDefaultFont();
+    lcd.print(" no");
+}